@@ -0,0 +1,151 @@
+#include <benchmark/benchmark.h>
+#include <memory_pool/allocator.hpp>
+#include <memory_pool/latency.hpp>
+#include <memory_pool/shared_pool.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Blocking allocation on a full pool: mp::shared_pool::allocate_wait() (sleeps on the occupancy counter, wakes one
+// sleeper per freed slot) against the usual mutex + condition variable around mp::pool.
+
+namespace {
+
+using namespace std::chrono_literals;
+
+struct Item {
+    std::array<std::uint64_t, 8u> payload{};
+};
+
+constexpr size_t slots = 4u;
+
+struct shared_pool_wait {
+    mp::shared_pool<Item, slots> pool;
+
+    shared_pool_wait() { std::ignore = pool.initialize(); }
+
+    Item* acquire() { return pool.allocate_wait(10s).value_or(nullptr); }
+    void release(Item* item) { std::ignore = pool.deallocate(item); }
+};
+
+struct condition_variable_pool {
+    mp::pool<Item, slots> pool = *mp::pool<Item, slots>::create();
+    std::mutex mutex;
+    std::condition_variable freed;
+    size_t waiters{0u};
+
+    Item* acquire() {
+        std::unique_lock lock{mutex};
+        Item* item{nullptr};
+        ++waiters;
+        freed.wait_for(lock, 10s, [&] { return (item = pool.try_allocate()) != nullptr; });
+        --waiters;
+        return item;
+    }
+    void release(Item* item) {
+        bool notify{false};
+        {
+            std::lock_guard lock{mutex};
+            pool.deallocate_unchecked(item);
+            notify = waiters != 0u;
+        }
+        if (notify) {
+            freed.notify_one();
+        }
+    }
+};
+
+std::uint64_t elapsed_ns(std::chrono::steady_clock::time_point since) {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - since).count());
+}
+
+/**
+ * state.range(0) threads for `slots` slots, each one acquiring, touching and releasing an item in a loop.
+ */
+template <typename TBackend>
+void BM_throughput(benchmark::State& state) {
+    const auto threads = static_cast<size_t>(state.range(0));
+    constexpr size_t rounds = 20'000u;
+    auto backend = std::make_unique<TBackend>();
+
+    for (auto _ : state) {
+        std::latch ready{static_cast<std::ptrdiff_t>(threads + 1u)};
+        std::vector<std::jthread> workers;
+
+        for (size_t t = 0u; t < threads; ++t) {
+            workers.emplace_back([&] {
+                ready.arrive_and_wait();
+                for (size_t round = 0u; round < rounds; ++round) {
+                    Item* item = backend->acquire();
+                    item->payload[round % item->payload.size()] = round;
+                    benchmark::DoNotOptimize(item->payload);
+                    backend->release(item);
+                }
+            });
+        }
+        const auto start = std::chrono::steady_clock::now();
+        ready.arrive_and_wait();
+        workers.clear();
+        state.SetIterationTime(static_cast<double>(elapsed_ns(start)) * 1e-9);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(threads * rounds));
+}
+
+/**
+ * Time between the release of a slot and the return of the thread sleeping for it.
+ */
+template <typename TBackend>
+void BM_wakeup_latency(benchmark::State& state) {
+    auto backend = std::make_unique<TBackend>();
+    std::vector<Item*> held;
+    for (size_t i = 0u; i < slots; ++i) {
+        held.push_back(backend->acquire());
+    }
+    mp::latency_histogram latencies;
+
+    for (auto _ : state) {
+        std::atomic<std::chrono::steady_clock::time_point> released{};
+        std::atomic_uint64_t woken_after{0u};
+
+        std::jthread sleeper{[&] {
+            Item* item = backend->acquire();
+            woken_after.store(elapsed_ns(released.load()), std::memory_order_release);
+            backend->release(item);
+        }};
+        // Leaves the sleeper the time to block
+        std::this_thread::sleep_for(200us);
+        released.store(std::chrono::steady_clock::now());
+        backend->release(held.back());
+        sleeper.join();
+
+        const auto latency = woken_after.load(std::memory_order_acquire);
+        latencies.record(latency);
+        state.SetIterationTime(static_cast<double>(latency) * 1e-9);
+        held.back() = backend->acquire();
+    }
+    state.counters["p50_ns"] = static_cast<double>(latencies.percentile(50.0));
+    state.counters["p99_ns"] = static_cast<double>(latencies.percentile(99.0));
+    state.counters["max_ns"] = static_cast<double>(latencies.max());
+
+    for (Item* item : held) {
+        backend->release(item);
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_throughput<shared_pool_wait>)->Arg(2)->Arg(8)->Arg(32)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_throughput<condition_variable_pool>)->Arg(2)->Arg(8)->Arg(32)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_wakeup_latency<shared_pool_wait>)->Iterations(2000)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_wakeup_latency<condition_variable_pool>)->Iterations(2000)->UseManualTime()->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
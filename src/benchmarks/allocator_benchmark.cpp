@@ -0,0 +1,256 @@
+#include <benchmark/benchmark.h>
+#include <memory_pool/allocator.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+// Allocation suite: mp::pool against new/delete, malloc/free and the std::pmr pool resources, for several pool
+// capacities, object sizes and release orders. Every benchmark is named <scenario>/<backend>/<sizeof>B/N=<capacity>,
+// e.g. run with --benchmark_filter='random/.*/64B' and --benchmark_out=suite.json --benchmark_out_format=json for
+// machine readable results (the run_benchmarks target does the latter).
+
+namespace {
+
+template <size_t NSize>
+struct Object {
+    std::array<std::byte, NSize> bytes{};
+};
+
+// Backends, all of them construct a value-initialized object and destroy it on release
+
+/**
+ * mp::pool through the checked std::expected interface.
+ */
+template <typename T, size_t N>
+struct mp_checked {
+    static constexpr const char* name = "mp_checked";
+
+    mp::pool<T, N> pool = *mp::pool<T, N>::create();
+
+    T* allocate() { return *pool.allocate(); }
+    void deallocate(T* p) { std::ignore = pool.deallocate(p); }
+};
+
+/**
+ * mp::pool through try_allocate() / deallocate_unchecked().
+ */
+template <typename T, size_t N>
+struct mp_unchecked {
+    static constexpr const char* name = "mp_unchecked";
+
+    mp::pool<T, N> pool = *mp::pool<T, N>::create();
+
+    T* allocate() { return pool.try_allocate(); }
+    void deallocate(T* p) { pool.deallocate_unchecked(p); }
+};
+
+template <typename T, size_t>
+struct new_delete {
+    static constexpr const char* name = "new_delete";
+
+    T* allocate() { return new T{}; }
+    void deallocate(T* p) { delete p; }
+};
+
+template <typename T, size_t>
+struct malloc_free {
+    static constexpr const char* name = "malloc_free";
+
+    T* allocate() { return ::new (std::malloc(sizeof(T))) T{}; }
+    void deallocate(T* p) {
+        std::destroy_at(p);
+        std::free(p);
+    }
+};
+
+template <typename T, size_t>
+struct pmr_unsynchronized {
+    static constexpr const char* name = "pmr_unsynchronized_pool";
+
+    std::pmr::unsynchronized_pool_resource resource;
+    std::pmr::polymorphic_allocator<T> alloc{&resource};
+
+    T* allocate() { return alloc.template new_object<T>(); }
+    void deallocate(T* p) { alloc.delete_object(p); }
+};
+
+template <typename T, size_t>
+struct pmr_synchronized {
+    static constexpr const char* name = "pmr_synchronized_pool";
+
+    std::pmr::synchronized_pool_resource resource;
+    std::pmr::polymorphic_allocator<T> alloc{&resource};
+
+    T* allocate() { return alloc.template new_object<T>(); }
+    void deallocate(T* p) { alloc.delete_object(p); }
+};
+
+// Scenarios
+
+enum class order_e { lifo, fifo, random };
+
+constexpr const char* to_string(order_e order) {
+    switch (order) {
+    case order_e::lifo:
+        return "lifo";
+    case order_e::fifo:
+        return "fifo";
+    case order_e::random:
+        return "random";
+    }
+    return "";
+}
+
+/**
+ * One allocation immediately released, the best case of every allocator.
+ */
+template <typename TBackend>
+void BM_pair(benchmark::State& state) {
+    auto backend = std::make_unique<TBackend>();
+
+    for (auto _ : state) {
+        auto* p = backend->allocate();
+        benchmark::DoNotOptimize(p);
+        backend->deallocate(p);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * Fills the whole capacity, then releases everything in the given order.
+ */
+template <typename TBackend, size_t N, order_e Order>
+void BM_fill_drain(benchmark::State& state) {
+    using value_t = std::remove_pointer_t<decltype(std::declval<TBackend&>().allocate())>;
+
+    auto backend = std::make_unique<TBackend>();
+    std::vector<value_t*> objects(N);
+    std::vector<size_t> release_order(N);
+    std::iota(release_order.begin(), release_order.end(), 0u);
+
+    if constexpr (Order == order_e::lifo) {
+        std::reverse(release_order.begin(), release_order.end());
+    } else if constexpr (Order == order_e::random) {
+        std::shuffle(release_order.begin(), release_order.end(), std::mt19937_64{42u});
+    }
+
+    for (auto _ : state) {
+        for (auto& p : objects) {
+            p = backend->allocate();
+        }
+        benchmark::ClobberMemory();
+        for (const size_t i : release_order) {
+            backend->deallocate(objects[i]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(N));
+}
+
+/**
+ * allocate_bucket<SIZE>() against SIZE single allocations, both released one by one.
+ */
+template <typename T, size_t N, size_t SIZE>
+void BM_bucket(benchmark::State& state) {
+    auto pool = *mp::pool<T, N>::create();
+
+    for (auto _ : state) {
+        auto bucket = pool.template allocate_bucket<SIZE>();
+        benchmark::DoNotOptimize(bucket);
+        std::ignore = pool.deallocate(*bucket);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(SIZE));
+}
+
+template <typename T, size_t N, size_t SIZE>
+void BM_bucket_singles(benchmark::State& state) {
+    auto pool = *mp::pool<T, N>::create();
+    std::array<T*, SIZE> objects{};
+
+    for (auto _ : state) {
+        for (auto& p : objects) {
+            p = *pool.allocate();
+        }
+        benchmark::DoNotOptimize(objects);
+        for (auto* p : objects) {
+            std::ignore = pool.deallocate(p);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(SIZE));
+}
+
+// Registration
+
+template <size_t NSize, size_t N>
+std::string suffix() {
+    return "/" + std::to_string(NSize) + "B/N=" + std::to_string(N);
+}
+
+template <template <typename, size_t> typename TBackend, size_t NSize, size_t N>
+void register_backend() {
+    using backend_t = TBackend<Object<NSize>, N>;
+    const std::string name = std::string{backend_t::name} + suffix<NSize, N>();
+
+    benchmark::RegisterBenchmark(("pair/" + name).c_str(), BM_pair<backend_t>);
+    [&]<order_e... Orders>() {
+        (benchmark::RegisterBenchmark((std::string{to_string(Orders)} + "/" + name).c_str(),
+                                      BM_fill_drain<backend_t, N, Orders>),
+         ...);
+    }.template operator()<order_e::lifo, order_e::fifo, order_e::random>();
+}
+
+template <size_t NSize, size_t N>
+void register_capacity() {
+    register_backend<mp_checked, NSize, N>();
+    register_backend<mp_unchecked, NSize, N>();
+    register_backend<new_delete, NSize, N>();
+    register_backend<malloc_free, NSize, N>();
+    register_backend<pmr_unsynchronized, NSize, N>();
+    register_backend<pmr_synchronized, NSize, N>();
+}
+
+template <size_t NSize, size_t N, size_t SIZE>
+void register_bucket() {
+    benchmark::RegisterBenchmark(("bucket/allocate_bucket/" + std::to_string(SIZE) + suffix<NSize, N>()).c_str(),
+                                 BM_bucket<Object<NSize>, N, SIZE>);
+    benchmark::RegisterBenchmark(("bucket/singles/" + std::to_string(SIZE) + suffix<NSize, N>()).c_str(),
+                                 BM_bucket_singles<Object<NSize>, N, SIZE>);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Small capacities stay in L1/L2, the big ones measure the bitmap scan and the cache misses. The largest
+    // capacity is only run for small objects so the suite stays below ~1 GiB of memory.
+    register_capacity<8u, 64u>();
+    register_capacity<64u, 64u>();
+    register_capacity<256u, 64u>();
+    register_capacity<8u, 4096u>();
+    register_capacity<64u, 4096u>();
+    register_capacity<256u, 4096u>();
+    register_capacity<8u, 65536u>();
+    register_capacity<64u, 65536u>();
+    register_capacity<8u, 1u << 20u>();
+    register_capacity<64u, 1u << 20u>();
+    register_capacity<8u, 1u << 24u>();
+
+    register_bucket<64u, 4096u, 8u>();
+    register_bucket<64u, 4096u, 64u>();
+    register_bucket<64u, 4096u, 512u>();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
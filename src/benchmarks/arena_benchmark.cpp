@@ -0,0 +1,148 @@
+#include <benchmark/benchmark.h>
+#include <memory_pool/arena.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+// One request = a batch of heterogeneous temporaries that all die together: mp::arena (make() then reset()) against
+// malloc/free and new/delete of every temporary.
+
+namespace {
+
+struct Header {
+    std::uint32_t id{0u};
+    std::uint32_t flags{0u};
+    std::uint64_t timestamp{0u};
+};
+
+struct Row {
+    std::array<double, 12u> values{};
+};
+
+// Non-trivial destructor, registered by the arena
+struct Span {
+    std::uint64_t* closed{nullptr};
+    ~Span() { ++*closed; }
+};
+
+constexpr size_t buffer_size = 256u;
+constexpr size_t kinds = 4u;
+
+/**
+ * state.range(0) temporaries per request, the four kinds in turn.
+ */
+void BM_request_arena(benchmark::State& state) {
+    const auto temporaries = static_cast<size_t>(state.range(0));
+    auto arena = std::make_unique<mp::arena<1u << 20u>>();
+    std::ignore = arena->initialize();
+    std::uint64_t closed{0u};
+
+    for (auto _ : state) {
+        for (size_t i = 0u; i < temporaries; ++i) {
+            switch (i % kinds) {
+            case 0u:
+                benchmark::DoNotOptimize(*arena->make<Header>(static_cast<std::uint32_t>(i)));
+                break;
+            case 1u:
+                benchmark::DoNotOptimize(*arena->make<Row>());
+                break;
+            case 2u:
+                benchmark::DoNotOptimize(*arena->allocate(buffer_size, 16u));
+                break;
+            default:
+                benchmark::DoNotOptimize(*arena->make<Span>(&closed));
+                break;
+            }
+        }
+        arena->reset();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(temporaries));
+}
+
+void BM_request_malloc_free(benchmark::State& state) {
+    const auto temporaries = static_cast<size_t>(state.range(0));
+    std::vector<void*> allocated(temporaries);
+    std::uint64_t closed{0u};
+
+    for (auto _ : state) {
+        for (size_t i = 0u; i < temporaries; ++i) {
+            switch (i % kinds) {
+            case 0u:
+                allocated[i] = ::new (std::malloc(sizeof(Header))) Header{static_cast<std::uint32_t>(i)};
+                break;
+            case 1u:
+                allocated[i] = ::new (std::malloc(sizeof(Row))) Row{};
+                break;
+            case 2u:
+                allocated[i] = std::malloc(buffer_size);
+                break;
+            default:
+                allocated[i] = ::new (std::malloc(sizeof(Span))) Span{&closed};
+                break;
+            }
+            benchmark::DoNotOptimize(allocated[i]);
+        }
+        for (size_t i = 0u; i < temporaries; ++i) {
+            if (i % kinds == kinds - 1u) {
+                std::destroy_at(static_cast<Span*>(allocated[i]));
+            }
+            std::free(allocated[i]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(temporaries));
+}
+
+void BM_request_new_delete(benchmark::State& state) {
+    const auto temporaries = static_cast<size_t>(state.range(0));
+    std::vector<void*> allocated(temporaries);
+    std::uint64_t closed{0u};
+
+    for (auto _ : state) {
+        for (size_t i = 0u; i < temporaries; ++i) {
+            switch (i % kinds) {
+            case 0u:
+                allocated[i] = new Header{static_cast<std::uint32_t>(i)};
+                break;
+            case 1u:
+                allocated[i] = new Row{};
+                break;
+            case 2u:
+                allocated[i] = new std::byte[buffer_size];
+                break;
+            default:
+                allocated[i] = new Span{&closed};
+                break;
+            }
+            benchmark::DoNotOptimize(allocated[i]);
+        }
+        for (size_t i = 0u; i < temporaries; ++i) {
+            switch (i % kinds) {
+            case 0u:
+                delete static_cast<Header*>(allocated[i]);
+                break;
+            case 1u:
+                delete static_cast<Row*>(allocated[i]);
+                break;
+            case 2u:
+                delete[] static_cast<std::byte*>(allocated[i]);
+                break;
+            default:
+                delete static_cast<Span*>(allocated[i]);
+                break;
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(temporaries));
+}
+
+} // namespace
+
+BENCHMARK(BM_request_arena)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(BM_request_malloc_free)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(BM_request_new_delete)->RangeMultiplier(4)->Range(16, 1024);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+#include <memory_pool/buddy_allocator.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+// Message buffers of up to 64 KB churning in a 4 MB region: a live set of state.range(0) buffers where every step
+// frees a random buffer and allocates a new one. mp::buddy_allocator against malloc/free, plus the fragmentation of
+// the buddy region.
+
+namespace {
+
+using buddy_t = mp::buddy_allocator<64u, 65536u, 64u>;
+
+/**
+ * Mostly small messages with a long tail: 60% from 16 to 512 B, 30% up to 4 KB, 9% up to 16 KB, 1% up to 64 KB.
+ */
+std::vector<size_t> make_sizes(size_t count) {
+    std::mt19937_64 rng{42u};
+    std::vector<size_t> sizes(count);
+
+    for (auto& size : sizes) {
+        const auto bucket = rng() % 100u;
+        const size_t low = bucket < 60u ? 16u : bucket < 90u ? 512u : bucket < 99u ? 4096u : 16384u;
+        const size_t high = bucket < 60u ? 512u : bucket < 90u ? 4096u : bucket < 99u ? 16384u : 65536u;
+        size = low + rng() % (high - low + 1u);
+    }
+    return sizes;
+}
+
+constexpr size_t steps = 1u << 16u;
+
+struct buddy_backend {
+    std::unique_ptr<buddy_t> buddy = std::make_unique<buddy_t>();
+    size_t failures{0u};
+
+    buddy_backend() { std::ignore = buddy->initialize(); }
+
+    void* allocate(size_t bytes) {
+        auto block = buddy->allocate(bytes);
+        failures += block ? 0u : 1u;
+        return block.value_or(nullptr);
+    }
+    void deallocate(void* block) {
+        if (block) {
+            std::ignore = buddy->deallocate(block);
+        }
+    }
+};
+
+struct malloc_backend {
+    size_t failures{0u};
+
+    void* allocate(size_t bytes) { return std::malloc(bytes); }
+    void deallocate(void* block) { std::free(block); }
+};
+
+template <typename TBackend>
+void BM_churn(benchmark::State& state) {
+    const auto live_count = static_cast<size_t>(state.range(0));
+    const std::vector<size_t> sizes = make_sizes(live_count + steps);
+    std::vector<size_t> victims(steps);
+    std::mt19937_64 rng{7u};
+    for (auto& victim : victims) {
+        victim = rng() % live_count;
+    }
+    TBackend backend;
+    std::vector<void*> live(live_count);
+    std::vector<size_t> requested(live_count);
+
+    for (size_t i = 0u; i < live_count; ++i) {
+        live[i] = backend.allocate(sizes[i]);
+        requested[i] = live[i] ? sizes[i] : 0u;
+    }
+    size_t step{0u};
+
+    for (auto _ : state) {
+        const size_t victim = victims[step % steps];
+        const size_t size = sizes[live_count + step % steps];
+        backend.deallocate(live[victim]);
+        live[victim] = backend.allocate(size);
+        requested[victim] = live[victim] ? size : 0u;
+        benchmark::DoNotOptimize(live[victim]);
+        ++step;
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if constexpr (std::is_same_v<TBackend, buddy_backend>) {
+        // Internal: lost to the rounding to powers of two; external: free space not available as whole 64 KB blocks
+        const auto status = backend.buddy->status();
+        const auto payload = static_cast<double>(std::accumulate(requested.begin(), requested.end(), size_t{0u}));
+        state.counters["used_kb"] = static_cast<double>(status.used) / 1024.0;
+        state.counters["internal_frag"] = status.used ? 1.0 - payload / static_cast<double>(status.used) : 0.0;
+        const auto whole = static_cast<double>(backend.buddy->free_blocks(65536u) * 65536u);
+        state.counters["external_frag"] = status.free ? 1.0 - whole / static_cast<double>(status.free) : 0.0;
+        state.counters["failures"] = static_cast<double>(backend.failures);
+    }
+    for (void* block : live) {
+        backend.deallocate(block);
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_churn<buddy_backend>)->Arg(128)->Arg(512)->Arg(1024);
+BENCHMARK(BM_churn<malloc_backend>)->Arg(128)->Arg(512)->Arg(1024);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include <memory_pool/pooled_promise.hpp>
+
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Spawn / run / destroy of short-lived coroutines with the frames from the global heap against mp::pooled_promise.
+
+namespace {
+
+struct heap_promise {};
+
+// The frames of work() are 48 bytes with GCC, checked by frames_are_pooled()
+using pooled_promise = mp::pooled_promise<64u, 4096u>;
+
+template <typename TPromiseBase>
+struct Task {
+    struct promise_type : TPromiseBase {
+        int value{0};
+
+        Task get_return_object() { return Task{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_value(int v) { value = v; }
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit Task(std::coroutine_handle<promise_type> h) : handle{h} {}
+    Task(Task&& other) noexcept : handle{std::exchange(other.handle, {})} {}
+    Task(const Task&) = delete;
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    int get() {
+        handle.resume();
+        return handle.promise().value;
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+template <typename TPromiseBase>
+Task<TPromiseBase> work(int a, int b) {
+    co_return a * b + 1;
+}
+
+bool frames_are_pooled() {
+    auto probe = work<pooled_promise>(1, 2);
+    return pooled_promise::pooled_frames() == 1u;
+}
+
+/**
+ * One task at a time: spawn, run to completion, destroy.
+ */
+template <typename TPromiseBase>
+void BM_spawn_destroy(benchmark::State& state) {
+    if (std::is_same_v<TPromiseBase, pooled_promise> && !frames_are_pooled()) {
+        state.SkipWithError("coroutine frame bigger than the pool blocks");
+        return;
+    }
+    int i{0};
+    for (auto _ : state) {
+        auto task = work<TPromiseBase>(i, 3);
+        benchmark::DoNotOptimize(task.get());
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * Fan-out: state.range(0) tasks alive at once, then run and destroyed.
+ */
+template <typename TPromiseBase>
+void BM_fan_out(benchmark::State& state) {
+    const auto fan_out = static_cast<int>(state.range(0));
+    std::vector<Task<TPromiseBase>> tasks;
+    tasks.reserve(static_cast<size_t>(fan_out));
+
+    for (auto _ : state) {
+        for (int i = 0; i < fan_out; ++i) {
+            tasks.push_back(work<TPromiseBase>(i, 3));
+        }
+        for (auto& task : tasks) {
+            benchmark::DoNotOptimize(task.get());
+        }
+        tasks.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * fan_out);
+}
+
+} // namespace
+
+BENCHMARK(BM_spawn_destroy<heap_promise>)->Iterations(1'000'000);
+BENCHMARK(BM_spawn_destroy<pooled_promise>)->Iterations(1'000'000);
+BENCHMARK(BM_fan_out<heap_promise>)->Arg(64)->Arg(1024)->Arg(4096);
+BENCHMARK(BM_fan_out<pooled_promise>)->Arg(64)->Arg(1024)->Arg(4096);
+
+BENCHMARK_MAIN();
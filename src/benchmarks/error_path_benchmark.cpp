@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+#include <memory_pool/allocator.hpp>
+#include <memory_pool/slot_map.hpp>
+
+#include <memory>
+#include <string>
+
+// Built twice, with and without MP_LEAN_ERRORS, see CMakeLists.txt
+
+namespace {
+
+struct Parameter {
+    std::string id{};
+    float value{0.f};
+};
+
+constexpr size_t pool_size = 4096u;
+
+/**
+ * allocate() on a full pool, the routine not_enough_space_in_allocator case.
+ */
+void BM_allocate_when_full(benchmark::State& state) {
+    auto pool = std::make_unique<mp::allocator<Parameter, pool_size>>();
+    std::ignore = pool->initialize();
+    while (pool->allocate()) {
+    }
+
+    for (auto _ : state) {
+        auto result = pool->allocate();
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * Failure carrying a formatted description.
+ */
+void BM_deallocate_stale_handle(benchmark::State& state) {
+    auto map = std::make_unique<mp::slot_map<Parameter, pool_size>>();
+    std::ignore = map->initialize();
+
+    const auto handle = *map->allocate();
+    std::ignore = map->deallocate(handle);
+
+    for (auto _ : state) {
+        auto result = map->deallocate(handle);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_allocate_when_full);
+BENCHMARK(BM_deallocate_stale_handle);
+
+BENCHMARK_MAIN();
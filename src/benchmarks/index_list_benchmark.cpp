@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+#include <memory_pool/allocator.hpp>
+#include <memory_pool/index_list.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <malloc.h>
+
+// Footprint and traversal of a doubly linked list of 16-byte payloads: mp::index_list over an mp::allocator (16 or
+// 32-bit links inside the object) against std::list (two pointers plus one heap block per element). Elements are
+// linked in a shuffled order so neither list walks its memory sequentially. bytes_per_node is the heap growth
+// measured by mallinfo2() divided by the element count, allocator storage and registry included.
+
+namespace {
+
+struct payload_t {
+    std::uint64_t key{0u};
+    std::uint64_t value{0u};
+};
+
+template <size_t NAlloc>
+struct node_t {
+    payload_t payload{};
+    mp::list_hook_t<NAlloc> link{};
+};
+
+size_t heap_in_use() { return ::mallinfo2().uordblks; }
+
+std::vector<size_t> shuffled_order(size_t count) {
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), 0u);
+    std::shuffle(order.begin(), order.end(), std::mt19937_64{42u});
+    return order;
+}
+
+template <size_t NAlloc>
+void BM_index_list(benchmark::State& state) {
+    using node = node_t<NAlloc>;
+
+    std::vector<node*> nodes(NAlloc);
+    const size_t before = heap_in_use();
+    auto alloc = std::make_unique<mp::allocator<node, NAlloc>>();
+    std::ignore = alloc->initialize();
+    mp::index_list<node, NAlloc, &node::link> list{*alloc};
+
+    for (size_t i = 0u; i < NAlloc; ++i) {
+        nodes[i] = alloc->try_allocate(node{.payload = {i, i * 3u}});
+    }
+    const size_t footprint = heap_in_use() - before;
+    for (const size_t i : shuffled_order(NAlloc)) {
+        list.push_back(*nodes[i]);
+    }
+
+    for (auto _ : state) {
+        std::uint64_t sum{0u};
+        for (const node& n : list) {
+            sum += n.payload.value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(NAlloc));
+    state.counters["bytes_per_node"] = static_cast<double>(footprint) / static_cast<double>(NAlloc);
+    state.counters["link_bytes"] = sizeof(mp::list_hook_t<NAlloc>);
+}
+
+template <size_t NAlloc>
+void BM_std_list(benchmark::State& state) {
+    std::vector<std::list<payload_t>::iterator> positions(NAlloc);
+    const size_t before = heap_in_use();
+    std::list<payload_t> list;
+
+    // Elements allocated in index order, then spliced in the shuffled order
+    for (size_t i = 0u; i < NAlloc; ++i) {
+        positions[i] = list.insert(list.end(), payload_t{i, i * 3u});
+    }
+    const size_t footprint = heap_in_use() - before;
+    for (const size_t i : shuffled_order(NAlloc)) {
+        list.splice(list.end(), list, positions[i]);
+    }
+
+    for (auto _ : state) {
+        std::uint64_t sum{0u};
+        for (const payload_t& p : list) {
+            sum += p.value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(NAlloc));
+    state.counters["bytes_per_node"] = static_cast<double>(footprint) / static_cast<double>(NAlloc);
+    state.counters["link_bytes"] = 2u * sizeof(void*);
+}
+
+} // namespace
+
+// 16-bit links, fits in L2
+BENCHMARK(BM_index_list<16'384u>);
+BENCHMARK(BM_std_list<16'384u>);
+// 16-bit links, largest pool
+BENCHMARK(BM_index_list<65'535u>);
+BENCHMARK(BM_std_list<65'535u>);
+// 32-bit links, past the caches
+BENCHMARK(BM_index_list<1'048'576u>);
+BENCHMARK(BM_std_list<1'048'576u>);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,140 @@
+#include <benchmark/benchmark.h>
+#include <memory_pool/io_buffer_pool.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Echo through a local socketpair: the client writes a message, the relay end receives it and sends it back, the
+// client reads the echo. The relay either reads straight into pooled buffers and writes them back with one readv()
+// and one writev() (zero copy), or reads into a staging buffer and copies the message into a heap buffer before
+// writing it, the usual copying path.
+
+namespace {
+
+constexpr size_t max_message = 64u * 1024u;
+
+class socket_pair {
+public:
+    socket_pair() {
+        std::ignore = ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds_.data());
+        // Room for a whole message in flight in each direction
+        const int size = 4 * static_cast<int>(max_message);
+        for (const int fd : fds_) {
+            std::ignore = ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+            std::ignore = ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+        }
+    }
+    ~socket_pair() {
+        ::close(fds_[0]);
+        ::close(fds_[1]);
+    }
+    socket_pair(const socket_pair&) = delete;
+    socket_pair& operator=(const socket_pair&) = delete;
+
+    [[nodiscard]] int client() const { return fds_[0]; }
+    [[nodiscard]] int relay() const { return fds_[1]; }
+
+private:
+    std::array<int, 2> fds_{};
+};
+
+void write_all(int fd, const std::byte* data, size_t size) {
+    while (size != 0u) {
+        const auto n = ::write(fd, data, size);
+        if (n <= 0) {
+            return;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+void read_all(int fd, std::byte* data, size_t size) {
+    while (size != 0u) {
+        const auto n = ::read(fd, data, size);
+        if (n <= 0) {
+            return;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+/**
+ * state.range(0) bytes per message, relayed in pooled buffers of NBlockSize bytes.
+ */
+template <size_t NBlockSize>
+void BM_echo_pooled(benchmark::State& state) {
+    using pool_t = mp::io_buffer_pool<NBlockSize, max_message / NBlockSize>;
+
+    const auto size = static_cast<size_t>(state.range(0));
+    const std::vector<std::byte> message(size, std::byte{0x5a});
+    std::vector<std::byte> echo(size);
+    socket_pair sockets;
+    auto pool = std::make_unique<pool_t>();
+    std::ignore = pool->initialize();
+    std::vector<typename pool_t::buffer> buffers;
+    std::array<iovec, max_message / NBlockSize> iov{};
+
+    for (auto _ : state) {
+        write_all(sockets.client(), message.data(), size);
+
+        for (size_t i = 0u; i < (size + NBlockSize - 1u) / NBlockSize; ++i) {
+            buffers.push_back(*pool->acquire());
+        }
+        for (size_t received = 0u; received < size;) {
+            const size_t count = pool_t::writable_iovecs(buffers, iov);
+            const auto n = ::readv(sockets.relay(), iov.data(), static_cast<int>(count));
+            if (n <= 0) {
+                break;
+            }
+            pool_t::commit(buffers, static_cast<size_t>(n));
+            received += static_cast<size_t>(n);
+        }
+        const size_t count = pool_t::readable_iovecs(buffers, iov);
+        std::ignore = ::writev(sockets.relay(), iov.data(), static_cast<int>(count));
+        buffers.clear();
+
+        read_all(sockets.client(), echo.data(), size);
+        benchmark::DoNotOptimize(echo.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+
+void BM_echo_copy(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    const std::vector<std::byte> message(size, std::byte{0x5a});
+    std::vector<std::byte> echo(size);
+    std::vector<std::byte> staging(max_message);
+    socket_pair sockets;
+
+    for (auto _ : state) {
+        write_all(sockets.client(), message.data(), size);
+
+        read_all(sockets.relay(), staging.data(), size);
+        auto copy = std::make_unique_for_overwrite<std::byte[]>(size);
+        std::memcpy(copy.get(), staging.data(), size);
+        write_all(sockets.relay(), copy.get(), size);
+
+        read_all(sockets.client(), echo.data(), size);
+        benchmark::DoNotOptimize(echo.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+
+} // namespace
+
+BENCHMARK(BM_echo_pooled<2048u>)->Arg(2048)->Arg(16384)->Arg(65536);
+BENCHMARK(BM_echo_pooled<4096u>)->Arg(2048)->Arg(16384)->Arg(65536);
+BENCHMARK(BM_echo_pooled<16384u>)->Arg(2048)->Arg(16384)->Arg(65536);
+BENCHMARK(BM_echo_pooled<65536u>)->Arg(2048)->Arg(16384)->Arg(65536);
+BENCHMARK(BM_echo_copy)->Arg(2048)->Arg(16384)->Arg(65536);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+#include <memory_pool/allocator.hpp>
+
+#include <memory>
+#include <vector>
+
+// Built three times, see CMakeLists.txt: latency_overhead_bench (no instrumentation), latency_overhead_clock_bench
+// (MP_LATENCY, clock_gettime) and latency_overhead_tsc_bench (MP_LATENCY with rdtsc). The difference between the
+// runs is the cost of timing each call; the instrumented builds also report percentiles of the recorded histograms.
+
+namespace {
+
+struct Point {
+    float x{0.f};
+    float y{0.f};
+    float z{0.f};
+};
+
+constexpr size_t pool_size = 4096u;
+
+using pool_t = mp::pool<Point, pool_size>;
+
+void report([[maybe_unused]] benchmark::State& state, [[maybe_unused]] const pool_t& pool) {
+#if defined(MP_LATENCY)
+    const auto latency = pool.latency_snapshot();
+    state.counters["alloc_p50"] = static_cast<double>(latency.allocate.percentile(50.0));
+    state.counters["alloc_p99"] = static_cast<double>(latency.allocate.percentile(99.0));
+    state.counters["dealloc_p99"] = static_cast<double>(latency.deallocate.percentile(99.0));
+#endif
+}
+
+void BM_allocate_deallocate(benchmark::State& state) {
+    auto pool = *pool_t::create();
+
+    for (auto _ : state) {
+        auto p = pool.allocate(1.f, 2.f, 3.f);
+        benchmark::DoNotOptimize(p);
+        std::ignore = pool.deallocate(*p);
+    }
+    state.SetItemsProcessed(state.iterations());
+    report(state, pool);
+}
+
+void BM_try_allocate_unchecked(benchmark::State& state) {
+    auto pool = *pool_t::create();
+
+    for (auto _ : state) {
+        Point* p = pool.try_allocate(1.f, 2.f, 3.f);
+        benchmark::DoNotOptimize(p);
+        pool.deallocate_unchecked(p);
+    }
+    state.SetItemsProcessed(state.iterations());
+    report(state, pool);
+}
+
+/**
+ * Fills and drains half the pool, so the fetch scans are not always served from the first word.
+ */
+void BM_fill_drain(benchmark::State& state) {
+    auto pool = *pool_t::create();
+    std::vector<Point*> points(pool_size / 2u);
+
+    for (auto _ : state) {
+        for (auto& p : points) {
+            p = pool.try_allocate();
+        }
+        for (auto* p : points) {
+            pool.deallocate_unchecked(p);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(points.size()));
+    report(state, pool);
+}
+
+} // namespace
+
+BENCHMARK(BM_allocate_deallocate);
+BENCHMARK(BM_try_allocate_unchecked);
+BENCHMARK(BM_fill_drain);
+
+BENCHMARK_MAIN();
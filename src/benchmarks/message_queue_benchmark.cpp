@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+#include <memory_pool/message_queue.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pipeline hand-off between threads: producers build messages and consumers process then drop them.
+// mp::message_queue (payload in a queue slot, 32-bit index through a lock-free ring) against the usual
+// std::mutex + std::deque of heap allocated messages. state.range(0) producers and as many consumers; on a single
+// core the threads yield instead of spinning.
+
+namespace {
+
+struct Message {
+    std::uint32_t producer{0u};
+    std::uint64_t sequence{0u};
+    std::array<std::uint64_t, 6u> payload{};
+};
+
+constexpr std::uint64_t messages_per_producer = 200'000u;
+constexpr size_t queue_capacity = 1024u;
+
+template <mp::queue_e Mode>
+struct pool_queue {
+    std::unique_ptr<mp::message_queue<Message, queue_capacity, Mode>> queue =
+        std::make_unique<mp::message_queue<Message, queue_capacity, Mode>>();
+
+    pool_queue() { std::ignore = queue->initialize(); }
+
+    bool push(std::uint32_t producer, std::uint64_t sequence) { return queue->emplace(producer, sequence).has_value(); }
+
+    template <typename TFn>
+    bool pop(TFn&& fn) {
+        return queue->consume(fn);
+    }
+};
+
+struct mutex_queue {
+    std::mutex mutex;
+    std::deque<std::unique_ptr<Message>> messages;
+
+    bool push(std::uint32_t producer, std::uint64_t sequence) {
+        auto message = std::make_unique<Message>(Message{producer, sequence});
+        std::lock_guard lock{mutex};
+        if (messages.size() == queue_capacity) {
+            return false;
+        }
+        messages.push_back(std::move(message));
+        return true;
+    }
+
+    template <typename TFn>
+    bool pop(TFn&& fn) {
+        std::unique_ptr<Message> message;
+        {
+            std::lock_guard lock{mutex};
+            if (messages.empty()) {
+                return false;
+            }
+            message = std::move(messages.front());
+            messages.pop_front();
+        }
+        fn(*message);
+        return true;
+    }
+};
+
+template <typename TQueue>
+void BM_pipeline(benchmark::State& state) {
+    const auto threads = static_cast<std::uint32_t>(state.range(0));
+    const std::uint64_t total = threads * messages_per_producer;
+
+    for (auto _ : state) {
+        TQueue queue;
+        std::atomic_uint64_t consumed{0u};
+        std::latch start{static_cast<std::ptrdiff_t>(2u * threads)};
+        {
+            std::vector<std::jthread> workers;
+            for (std::uint32_t c = 0u; c < threads; ++c) {
+                workers.emplace_back([&] {
+                    std::uint64_t checksum{0u};
+                    start.arrive_and_wait();
+                    while (consumed.load(std::memory_order_relaxed) < total) {
+                        if (queue.pop([&](Message& m) { checksum += m.sequence + m.payload[0]; })) {
+                            consumed.fetch_add(1u, std::memory_order_relaxed);
+                        } else {
+                            std::this_thread::yield();
+                        }
+                    }
+                    benchmark::DoNotOptimize(checksum);
+                });
+            }
+            for (std::uint32_t p = 0u; p < threads; ++p) {
+                workers.emplace_back([&, p] {
+                    start.arrive_and_wait();
+                    for (std::uint64_t i = 0u; i < messages_per_producer;) {
+                        if (queue.push(p, i)) {
+                            ++i;
+                        } else {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(total));
+}
+
+} // namespace
+
+BENCHMARK(BM_pipeline<pool_queue<mp::queue_e::spsc>>)->Arg(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_pipeline<pool_queue<mp::queue_e::mpmc>>)->Arg(1)->Arg(2)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_pipeline<mutex_queue>)->Arg(1)->Arg(2)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
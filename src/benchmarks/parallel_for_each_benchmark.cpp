@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include <memory_pool/allocator.hpp>
+#include <memory_pool/parallel.hpp>
+
+#include <cmath>
+#include <execution>
+#include <memory>
+#include <thread>
+
+namespace {
+
+struct Body {
+    float position[3]{};
+    float velocity[3]{};
+};
+
+constexpr size_t pool_size = 1u << 21u;
+
+using pool_t = mp::allocator<Body, pool_size>;
+
+/**
+ * Two thirds of the slots are live, with the holes concentrated in the first half so a static split would be uneven.
+ */
+pool_t& populated_pool() {
+    static auto pool = [] {
+        auto p = std::make_unique<pool_t>();
+        std::ignore = p->initialize();
+
+        for (size_t i = 0u; i < pool_size; ++i) {
+            auto body = p->allocate();
+            (*body)->velocity[0] = 1.f;
+            if (i < pool_size / 2u && i % 3u != 0u) {
+                std::ignore = p->deallocate(*body);
+            }
+        }
+        return p;
+    }();
+    return *pool;
+}
+
+void integrate(Body& body) {
+    for (size_t axis = 0u; axis < 3u; ++axis) {
+        body.position[axis] += body.velocity[axis] * 0.016f;
+        body.velocity[axis] *= std::exp(-0.001f);
+    }
+}
+
+void BM_for_each_live(benchmark::State& state) {
+    auto& pool = populated_pool();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pool.for_each_live(integrate));
+    }
+    state.SetItemsProcessed(state.iterations() * pool.status().used);
+}
+
+void BM_parallel_for_each_live(benchmark::State& state) {
+    auto& pool = populated_pool();
+    const auto threads = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(mp::parallel_for_each_live(pool, integrate, threads));
+    }
+    state.SetItemsProcessed(state.iterations() * pool.status().used);
+}
+
+void BM_parallel_for_each_live_par_unseq(benchmark::State& state) {
+    auto& pool = populated_pool();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(mp::parallel_for_each_live(std::execution::par_unseq, pool, integrate));
+    }
+    state.SetItemsProcessed(state.iterations() * pool.status().used);
+}
+
+void thread_counts(benchmark::internal::Benchmark* bench) {
+    const auto cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int threads = 1; threads <= cores; ++threads) {
+        bench->Arg(threads);
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_for_each_live)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_parallel_for_each_live)->Apply(thread_counts)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_parallel_for_each_live_par_unseq)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,380 @@
+#include <benchmark/benchmark.h>
+#include <memory_pool/allocator.hpp>
+#include <memory_pool/latency.hpp>
+#include <memory_pool/remote_free_pool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Producer threads allocate messages from a shared pool and hand them to consumer threads that free them, the
+// cross-thread free pattern of a message pipeline. Arguments are {producers, consumers, pin}; with pin the threads
+// are bound round-robin to the CPUs, producers first.
+//
+// Reported per topology: items_per_second, p50/p99/p99.9 of allocate (producers) and deallocate (consumers) in ns,
+// and the hardware cache misses per message and per cache reference (perf_event_open; -1 when the kernel or the
+// virtual machine does not expose the counters, e.g. kernel.perf_event_paranoid > 2).
+//
+// The shared pool goes through a backend making it safe to share; mutex_pool, one pool behind a mutex, is the
+// baseline every other mode should be compared with. sharded_mutex_pool and remote_free_pool give every producer its
+// own pool: the former has the consumers free directly into the owner's registry under the owner's mutex, the latter
+// queues the frees on mp::remote_free_pool's lock-free stack for the owner to drain.
+
+namespace {
+
+struct Message {
+    std::uint64_t sequence{0u};
+    std::uint32_t producer{0u};
+    std::array<std::uint64_t, 6u> payload{};
+};
+
+constexpr size_t ring_size = 256u;
+constexpr size_t max_threads = 8u;
+constexpr size_t pool_size = 2u * max_threads * max_threads * ring_size;
+constexpr size_t producer_pool_size = pool_size / max_threads;
+constexpr std::uint64_t messages_per_producer = 1u << 15u;
+
+// Backends: start(p) is called by producer p before its first allocate(p), deallocate() is called by the consumers
+
+/**
+ * mp::pool behind a std::mutex.
+ */
+struct mutex_pool {
+    mp::pool<Message, pool_size> pool = *mp::pool<Message, pool_size>::create();
+    std::mutex mutex;
+
+    void start(size_t) {}
+
+    Message* allocate(size_t) {
+        std::lock_guard lock{mutex};
+        return pool.try_allocate();
+    }
+    void deallocate(Message* message) {
+        std::lock_guard lock{mutex};
+        pool.deallocate_unchecked(message);
+    }
+};
+
+/**
+ * The global allocator, thread-safe by itself; for reference.
+ */
+struct new_delete {
+    void start(size_t) {}
+    Message* allocate(size_t) { return new Message{}; }
+    void deallocate(Message* message) { delete message; }
+};
+
+/**
+ * One mp::pool and one mutex per producer, consumers free into the owner's pool under its mutex.
+ */
+struct sharded_mutex_pool {
+    struct alignas(mp::cache_line_size) shard_t {
+        mp::pool<Message, producer_pool_size> pool = *mp::pool<Message, producer_pool_size>::create();
+        std::mutex mutex;
+    };
+    std::array<shard_t, max_threads> shards;
+
+    void start(size_t) {}
+
+    Message* allocate(size_t producer) {
+        auto& shard = shards[producer];
+        std::lock_guard lock{shard.mutex};
+        return shard.pool.try_allocate();
+    }
+    void deallocate(Message* message) {
+        auto& shard = shards[message->producer];
+        std::lock_guard lock{shard.mutex};
+        shard.pool.deallocate_unchecked(message);
+    }
+};
+
+/**
+ * One mp::remote_free_pool per producer, consumers push on the owner's remote free stack.
+ */
+struct remote_free_pool {
+    using pool_t = mp::remote_free_pool<Message, producer_pool_size>;
+
+    std::unique_ptr<pool_t[]> pools = std::make_unique<pool_t[]>(max_threads);
+
+    remote_free_pool() {
+        for (size_t p = 0u; p < max_threads; ++p) {
+            std::ignore = pools[p].initialize();
+        }
+    }
+
+    // Producer threads are new on every iteration
+    void start(size_t producer) { pools[producer].take_ownership(); }
+
+    Message* allocate(size_t producer) {
+        auto message = pools[producer].allocate();
+        return message ? *message : nullptr;
+    }
+    void deallocate(Message* message) { std::ignore = pools[message->producer].deallocate(message); }
+};
+
+/**
+ * Single producer single consumer ring carrying the messages from one producer to one consumer.
+ */
+class spsc_ring {
+public:
+    bool push(Message* message) {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == ring_size) {
+            return false;
+        }
+        slots_[tail % ring_size] = message;
+        tail_.store(tail + 1u, std::memory_order_release);
+        return true;
+    }
+
+    Message* pop() {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        Message* message = slots_[head % ring_size];
+        head_.store(head + 1u, std::memory_order_release);
+        return message;
+    }
+
+private:
+    std::array<Message*, ring_size> slots_{};
+    alignas(mp::cache_line_size) std::atomic_size_t head_{0u};
+    alignas(mp::cache_line_size) std::atomic_size_t tail_{0u};
+};
+
+/**
+ * Hardware counter of the calling thread, invalid when perf events are not available.
+ */
+class perf_counter {
+public:
+    explicit perf_counter(std::uint64_t config) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    ~perf_counter() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+    perf_counter(const perf_counter&) = delete;
+    perf_counter& operator=(const perf_counter&) = delete;
+
+    [[nodiscard]] bool valid() const { return fd_ >= 0; }
+
+    void start() {
+        if (valid()) {
+            ::ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    std::uint64_t stop() {
+        std::uint64_t value{0u};
+        if (valid()) {
+            ::ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (::read(fd_, &value, sizeof(value)) != sizeof(value)) {
+                value = 0u;
+            }
+        }
+        return value;
+    }
+
+private:
+    int fd_{-1};
+};
+
+void pin(std::thread& thread, size_t index) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(index % std::max(1u, std::thread::hardware_concurrency()), &cpus);
+    ::pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus);
+}
+
+/**
+ * What every thread reports once done.
+ */
+struct totals_t {
+    std::mutex mutex;
+    mp::latency_report_t latency;
+    std::uint64_t cache_misses{0u};
+    std::uint64_t cache_references{0u};
+    bool counters_valid{true};
+
+    void add(const mp::latency_report_t& local, perf_counter& misses, perf_counter& references) {
+        const auto local_misses = misses.stop();
+        const auto local_references = references.stop();
+        std::lock_guard lock{mutex};
+        latency.merge(local);
+        cache_misses += local_misses;
+        cache_references += local_references;
+        counters_valid = counters_valid && misses.valid() && references.valid();
+    }
+};
+
+std::uint64_t elapsed_ns(std::chrono::steady_clock::time_point start) {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+template <typename TBackend>
+void BM_producer_consumer(benchmark::State& state) {
+    const auto producers = static_cast<size_t>(state.range(0));
+    const auto consumers = static_cast<size_t>(state.range(1));
+    const bool pinned = state.range(2) != 0;
+    const std::uint64_t total = producers * messages_per_producer;
+
+    auto backend = std::make_unique<TBackend>();
+    totals_t totals;
+
+    for (auto _ : state) {
+        // rings[p * consumers + c] goes from producer p to consumer c
+        auto rings = std::make_unique<spsc_ring[]>(producers * consumers);
+        std::atomic_uint64_t consumed{0u};
+        std::latch ready{static_cast<std::ptrdiff_t>(producers + consumers + 1u)};
+        std::vector<std::thread> threads;
+
+        const auto producer = [&](size_t p) {
+            perf_counter misses{PERF_COUNT_HW_CACHE_MISSES};
+            perf_counter references{PERF_COUNT_HW_CACHE_REFERENCES};
+            mp::latency_report_t local;
+            backend->start(p);
+            ready.arrive_and_wait();
+            misses.start();
+            references.start();
+
+            for (std::uint64_t sequence = 0u; sequence < messages_per_producer; ++sequence) {
+                Message* message{nullptr};
+                for (;;) {
+                    const auto start = std::chrono::steady_clock::now();
+                    message = backend->allocate(p);
+                    if (message) {
+                        local.allocate.record(elapsed_ns(start));
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+                message->sequence = sequence;
+                message->producer = static_cast<std::uint32_t>(p);
+                message->payload.fill(sequence);
+
+                auto& ring = rings[p * consumers + sequence % consumers];
+                while (!ring.push(message)) {
+                    std::this_thread::yield();
+                }
+            }
+            totals.add(local, misses, references);
+        };
+
+        const auto consumer = [&](size_t c) {
+            perf_counter misses{PERF_COUNT_HW_CACHE_MISSES};
+            perf_counter references{PERF_COUNT_HW_CACHE_REFERENCES};
+            mp::latency_report_t local;
+            ready.arrive_and_wait();
+            misses.start();
+            references.start();
+
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                std::uint64_t popped{0u};
+                for (size_t p = 0u; p < producers; ++p) {
+                    while (Message* message = rings[p * consumers + c].pop()) {
+                        benchmark::DoNotOptimize(message->payload[message->sequence % message->payload.size()]);
+                        const auto start = std::chrono::steady_clock::now();
+                        backend->deallocate(message);
+                        local.deallocate.record(elapsed_ns(start));
+                        ++popped;
+                    }
+                }
+                if (popped == 0u) {
+                    std::this_thread::yield();
+                } else {
+                    consumed.fetch_add(popped, std::memory_order_relaxed);
+                }
+            }
+            totals.add(local, misses, references);
+        };
+
+        for (size_t p = 0u; p < producers; ++p) {
+            threads.emplace_back(producer, p);
+        }
+        for (size_t c = 0u; c < consumers; ++c) {
+            threads.emplace_back(consumer, c);
+        }
+        if (pinned) {
+            for (size_t i = 0u; i < threads.size(); ++i) {
+                pin(threads[i], i);
+            }
+        }
+        const auto start = std::chrono::steady_clock::now();
+        ready.arrive_and_wait();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        state.SetIterationTime(static_cast<double>(elapsed_ns(start)) * 1e-9);
+    }
+
+    const auto items = static_cast<double>(state.iterations() * total);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * total));
+    state.counters["alloc_p50"] = static_cast<double>(totals.latency.allocate.percentile(50.0));
+    state.counters["alloc_p99"] = static_cast<double>(totals.latency.allocate.percentile(99.0));
+    state.counters["alloc_p99.9"] = static_cast<double>(totals.latency.allocate.percentile(99.9));
+    state.counters["dealloc_p50"] = static_cast<double>(totals.latency.deallocate.percentile(50.0));
+    state.counters["dealloc_p99"] = static_cast<double>(totals.latency.deallocate.percentile(99.0));
+    state.counters["dealloc_p99.9"] = static_cast<double>(totals.latency.deallocate.percentile(99.9));
+
+    if (totals.counters_valid) {
+        state.counters["misses_per_msg"] = static_cast<double>(totals.cache_misses) / items;
+        state.counters["miss_rate"] =
+            totals.cache_references == 0u ? 0.0
+                                          : static_cast<double>(totals.cache_misses) /
+                                                static_cast<double>(totals.cache_references);
+    } else {
+        state.counters["misses_per_msg"] = -1.0;
+        state.counters["miss_rate"] = -1.0;
+    }
+}
+
+/**
+ * {producers, consumers, pin} topologies, up to max_threads of each.
+ */
+void topologies(benchmark::internal::Benchmark* bench) {
+    constexpr std::array<std::pair<int, int>, 6u> shapes{{{1, 1}, {1, 4}, {4, 1}, {2, 2}, {4, 4}, {8, 8}}};
+
+    for (const auto& [producers, consumers] : shapes) {
+        for (const int pinned : {0, 1}) {
+            bench->Args({producers, consumers, pinned});
+        }
+    }
+    bench->ArgNames({"producers", "consumers", "pin"});
+}
+
+} // namespace
+
+BENCHMARK(BM_producer_consumer<mutex_pool>)->Apply(topologies)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_producer_consumer<sharded_mutex_pool>)->Apply(topologies)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_producer_consumer<remote_free_pool>)->Apply(topologies)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_producer_consumer<new_delete>)->Apply(topologies)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+#include <memory_pool/allocator.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * String heavy message, every field outgrows the small string buffer.
+ */
+struct Message {
+    std::string topic{};
+    std::string payload{};
+    std::vector<std::string> headers{};
+
+    void reset() {
+        topic.clear();
+        payload.clear();
+        headers.clear();
+    }
+};
+
+constexpr size_t pool_size = 1024u;
+
+const std::string topic = "market-data/equities/europe/level-2";
+const std::string payload(512u, 'p');
+const std::string header = "x-correlation-id: 8f1c4e2a-7d3b-4c55-9a61-0e2f3b4d5c6a";
+
+void fill(Message& message) {
+    message.topic.assign(topic);
+    message.payload.assign(payload);
+    for (size_t i = 0u; i < 4u; ++i) {
+        message.headers.emplace_back(header);
+    }
+}
+
+/**
+ * Allocates a batch of messages, fills them and releases them, like a pipeline stage would do.
+ */
+template <mp::recycle_e Recycle>
+void BM_message_cycle(benchmark::State& state) {
+    using pool_t = mp::allocator<Message, pool_size, Recycle>;
+
+    auto pool = std::make_unique<pool_t>();
+    std::ignore = pool->initialize();
+
+    const auto batch = static_cast<size_t>(state.range(0));
+    std::vector<Message*> messages(batch);
+
+    for (auto _ : state) {
+        for (auto& message : messages) {
+            message = *pool->allocate();
+            fill(*message);
+        }
+        benchmark::ClobberMemory();
+        for (auto* message : messages) {
+            std::ignore = pool->deallocate(message);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch));
+}
+
+} // namespace
+
+BENCHMARK(BM_message_cycle<mp::recycle_e::destroy>)->Arg(1)->Arg(64)->Arg(pool_size);
+BENCHMARK(BM_message_cycle<mp::recycle_e::warm>)->Arg(1)->Arg(64)->Arg(pool_size);
+
+BENCHMARK_MAIN();
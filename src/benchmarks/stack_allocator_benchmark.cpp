@@ -0,0 +1,158 @@
+#include <benchmark/benchmark.h>
+#include <memory_pool/stack_allocator.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Recursive-descent parse of nested lists such as "[1,[2,3],[[4]]]". Every level collects the values of its items
+// in scratch nodes, reduces them and drops them before returning, strictly LIFO. The scratch nodes come from
+// mp::stack_allocator (one scope per level), from new/delete, or the values go to a std::vector per level.
+
+namespace {
+
+struct Node {
+    double value;
+    Node* next;
+};
+
+/**
+ * Nested lists of the given depth, `fanout` items per list.
+ */
+std::string make_document(size_t depth, size_t fanout) {
+    if (depth == 0u) {
+        return std::to_string(depth + fanout);
+    }
+    std::string list = "[";
+    for (size_t i = 0u; i < fanout; ++i) {
+        list += (i == 0u ? "" : ",") + (i % 2u == 0u ? make_document(depth - 1u, fanout) : std::to_string(i));
+    }
+    return list + "]";
+}
+
+template <typename TScratch>
+class parser {
+public:
+    parser(const std::string& text, TScratch& scratch) : text_{text}, scratch_{scratch} {}
+
+    double parse() {
+        pos_ = 0u;
+        return item();
+    }
+
+private:
+    double item() { return text_[pos_] == '[' ? list() : number(); }
+
+    double number() {
+        double value{0.0};
+        while (pos_ < text_.size() && text_[pos_] >= '0' && text_[pos_] <= '9') {
+            value = value * 10.0 + (text_[pos_++] - '0');
+        }
+        return value;
+    }
+
+    double list() {
+        ++pos_; // '['
+        auto level = scratch_.open();
+
+        while (text_[pos_] != ']') {
+            scratch_.push(level, item());
+            if (text_[pos_] == ',') {
+                ++pos_;
+            }
+        }
+        ++pos_; // ']'
+        return scratch_.reduce(level);
+    }
+
+    const std::string& text_;
+    TScratch& scratch_;
+    size_t pos_{0u};
+};
+
+// Alternating sum weighted by the position, so the whole list is read
+double weigh(double acc, double value, size_t position) { return acc + (position % 2u == 0u ? value : -0.5 * value); }
+
+struct stack_scratch {
+    std::unique_ptr<mp::stack_allocator<1u << 20u>> stack = std::make_unique<mp::stack_allocator<1u << 20u>>();
+
+    stack_scratch() { std::ignore = stack->initialize(); }
+
+    struct level_t {
+        mp::stack_allocator<1u << 20u>::scope_guard scope;
+        Node* head = nullptr;
+    };
+
+    level_t open() { return level_t{stack->scoped()}; }
+    void push(level_t& level, double value) { level.head = *stack->make<Node>(value, level.head); }
+    double reduce(level_t& level) {
+        double acc{0.0};
+        size_t position{0u};
+        for (const Node* node = level.head; node; node = node->next) {
+            acc = weigh(acc, node->value, position++);
+        }
+        return acc;
+    }
+};
+
+struct heap_scratch {
+    struct level_t {
+        Node* head = nullptr;
+    };
+
+    level_t open() { return {}; }
+    void push(level_t& level, double value) { level.head = new Node{value, level.head}; }
+    double reduce(level_t& level) {
+        double acc{0.0};
+        size_t position{0u};
+        for (Node* node = level.head; node;) {
+            acc = weigh(acc, node->value, position++);
+            delete std::exchange(node, node->next);
+        }
+        return acc;
+    }
+};
+
+struct vector_scratch {
+    using level_t = std::vector<double>;
+
+    level_t open() { return {}; }
+    void push(level_t& level, double value) { level.push_back(value); }
+    double reduce(level_t& level) {
+        double acc{0.0};
+        for (size_t position = level.size(); position-- > 0u;) {
+            acc = weigh(acc, level[position], level.size() - 1u - position);
+        }
+        return acc;
+    }
+};
+
+/**
+ * state.range(0) nesting levels, state.range(1) items per list.
+ */
+template <typename TScratch>
+void BM_parse(benchmark::State& state) {
+    const std::string document = make_document(static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1)));
+    TScratch scratch;
+    parser<TScratch> parse{document, scratch};
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parse.parse());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(document.size()));
+}
+
+void parse_arguments(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"depth", "fanout"});
+    bench->Args({4, 8})->Args({8, 4})->Args({12, 3})->Args({3, 64});
+}
+
+} // namespace
+
+BENCHMARK(BM_parse<stack_scratch>)->Apply(parse_arguments);
+BENCHMARK(BM_parse<heap_scratch>)->Apply(parse_arguments);
+BENCHMARK(BM_parse<vector_scratch>)->Apply(parse_arguments);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+#include <memory_pool/buddy_allocator.hpp>
+#include <memory_pool/latency.hpp>
+#include <memory_pool/tlsf_allocator.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Latency distribution of variable-size allocation under churn: a live set of state.range(0) blocks of 16 B - 16 KB
+// where every step frees a random block and allocates a new one. Each call is timed on its own, the tail (p99.9 and
+// max) is what a real-time path has to budget for. mp::tlsf_allocator against malloc/free and mp::buddy_allocator.
+// Timestamps come from mp::detail::latency_now(), so build with MP_LATENCY_TSC to count cycles instead of ns.
+
+namespace {
+
+constexpr size_t region_size = 32u << 20u;
+
+std::vector<size_t> make_sizes(size_t count) {
+    std::mt19937_64 rng{42u};
+    std::vector<size_t> sizes(count);
+
+    for (auto& size : sizes) {
+        const auto bucket = rng() % 100u;
+        const size_t low = bucket < 70u ? 16u : bucket < 95u ? 256u : 4096u;
+        const size_t high = bucket < 70u ? 256u : bucket < 95u ? 4096u : 16384u;
+        size = low + rng() % (high - low + 1u);
+    }
+    return sizes;
+}
+
+struct tlsf_backend {
+    std::unique_ptr<mp::tlsf_allocator<region_size>> tlsf = std::make_unique<mp::tlsf_allocator<region_size>>();
+
+    tlsf_backend() { std::ignore = tlsf->initialize(); }
+
+    void* allocate(size_t bytes) { return tlsf->allocate(bytes).value_or(nullptr); }
+    void deallocate(void* block) { std::ignore = tlsf->deallocate(block); }
+};
+
+struct buddy_backend {
+    using buddy_t = mp::buddy_allocator<16u, 16384u, region_size / 16384u>;
+    std::unique_ptr<buddy_t> buddy = std::make_unique<buddy_t>();
+
+    buddy_backend() { std::ignore = buddy->initialize(); }
+
+    void* allocate(size_t bytes) { return buddy->allocate(bytes).value_or(nullptr); }
+    void deallocate(void* block) { std::ignore = buddy->deallocate(block); }
+};
+
+struct malloc_backend {
+    void* allocate(size_t bytes) { return std::malloc(bytes); }
+    void deallocate(void* block) { std::free(block); }
+};
+
+void report(benchmark::State& state, const char* op, const mp::latency_histogram& histogram) {
+    const std::string prefix{op};
+    state.counters[prefix + "_mean"] = histogram.mean();
+    state.counters[prefix + "_p99"] = static_cast<double>(histogram.percentile(99.0));
+    state.counters[prefix + "_p99.9"] = static_cast<double>(histogram.percentile(99.9));
+    state.counters[prefix + "_max"] = static_cast<double>(histogram.max());
+}
+
+template <typename TBackend>
+void BM_latency(benchmark::State& state) {
+    const auto live_count = static_cast<size_t>(state.range(0));
+    constexpr size_t steps = 1u << 16u;
+    const std::vector<size_t> sizes = make_sizes(live_count + steps);
+    std::vector<size_t> victims(steps);
+    std::mt19937_64 rng{7u};
+    for (auto& victim : victims) {
+        victim = rng() % live_count;
+    }
+    auto backend = std::make_unique<TBackend>();
+    std::vector<void*> live(live_count);
+
+    for (size_t i = 0u; i < live_count; ++i) {
+        live[i] = backend->allocate(sizes[i]);
+    }
+    // One untimed pass first, so the page faults of the first touches stay out of the tail
+    for (size_t step = 0u; step < steps; ++step) {
+        void*& slot = live[victims[step]];
+        backend->deallocate(slot);
+        slot = backend->allocate(sizes[live_count + step]);
+    }
+    mp::latency_histogram allocations;
+    mp::latency_histogram deallocations;
+    size_t step{0u};
+
+    for (auto _ : state) {
+        void*& slot = live[victims[step % steps]];
+
+        auto start = mp::detail::latency_now();
+        backend->deallocate(slot);
+        auto end = mp::detail::latency_now();
+        deallocations.record(end - start);
+
+        start = mp::detail::latency_now();
+        slot = backend->allocate(sizes[live_count + step % steps]);
+        end = mp::detail::latency_now();
+        allocations.record(end - start);
+
+        benchmark::DoNotOptimize(slot);
+        ++step;
+    }
+    state.SetItemsProcessed(state.iterations());
+    report(state, "alloc", allocations);
+    report(state, "free", deallocations);
+
+    for (void* block : live) {
+        backend->deallocate(block);
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_latency<tlsf_backend>)->Arg(256)->Arg(4096)->Iterations(1u << 20u);
+BENCHMARK(BM_latency<buddy_backend>)->Arg(256)->Arg(4096)->Iterations(1u << 20u);
+BENCHMARK(BM_latency<malloc_backend>)->Arg(256)->Arg(4096)->Iterations(1u << 20u);
+
+BENCHMARK_MAIN();
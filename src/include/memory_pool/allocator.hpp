@@ -1,14 +1,21 @@
 
 #pragma once
 
+#include "latency.hpp"
+#include "probes.hpp"
 #include "slot_status_registry.hpp"
+#include "stats.hpp"
 
 #include <atomic>
+#include <cassert>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <expected>
 #include <iterator>
 #include <memory>
+#include <new>
 #include <stdexcept>
 #include <type_traits>
 
@@ -26,11 +33,30 @@ concept PointerType = std::is_pointer_v<T>;
 template <typename T>
 concept Allocatable = std::is_default_constructible_v<T>;
 
+/**
+ * Types that can be put back in a reusable state without being destroyed, see recycle_e::warm.
+ */
+template <typename T>
+concept Recyclable = requires(T& obj) { obj.reset(); };
+
+/**
+ * What happens to an object when its slot is released.
+ */
+enum class recycle_e {
+    destroy, //!< The object is destroyed on deallocate() and constructed again on allocate()
+    warm     //!< Every object is constructed once at initialize(), deallocate() only calls TAlloc::reset() so
+             //!< the resources owned by the object (string and vector capacity, ...) are reused by the next user
+};
+
+template <Allocatable TAlloc, size_t NAlloc, recycle_e Recycle = recycle_e::destroy>
+    requires(NAlloc > 0u && (Recycle == recycle_e::destroy || Recyclable<TAlloc>))
+class pool;
+
 /**
  * Reserves memory space on the heap
  */
-template <Allocatable TAlloc, size_t NAlloc>
-    requires(NAlloc > 0u)
+template <Allocatable TAlloc, size_t NAlloc, recycle_e Recycle = recycle_e::destroy>
+    requires(NAlloc > 0u && (Recycle == recycle_e::destroy || Recyclable<TAlloc>))
 class allocator final {
 public:
     /**
@@ -80,7 +106,7 @@ public:
                 return result_t::unexp({code_e::bad_logic, "The Bucket is empty or was not initialized properly"});
             }
             if (idx >= size_) {
-                return result_t::unexp({code_e::out_of_bounds, std::format("bucket::operator[] idx={}", idx)});
+                return result_t::unexp({code_e::out_of_bounds, error::describe("bucket::operator[] idx={}", idx)});
             }
             return data_[idx];
         }
@@ -90,7 +116,7 @@ public:
         }
 
     private:
-        friend class allocator<TAlloc, NAlloc>;
+        friend class allocator<TAlloc, NAlloc, Recycle>;
 
         [[nodiscard]] bool push_back(TBucket slot) {
             if (size_ < NBucket) {
@@ -105,6 +131,59 @@ public:
     };
     // End - Bucket
 
+    /**
+     * Forward range over the allocated objects, in address order.
+     */
+    class live_range final {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using pointer = TAlloc*;
+            using reference = TAlloc&;
+            using value_type = TAlloc;
+
+            iterator() = default;
+            iterator(allocator* owner, size_t idx) : owner_{owner}, idx_{idx} {}
+
+            reference operator*() const { return owner_->storage_[idx_]; }
+            pointer operator->() const { return &owner_->storage_[idx_]; }
+
+            // prefix increment
+            iterator& operator++() {
+                idx_ = owner_->registry_.next_in_use(idx_ + 1u);
+                return *this;
+            }
+            // postfix increment
+            iterator operator++(int) {
+                iterator tmp = *this;
+                ++(*this);
+                return tmp;
+            }
+
+            friend bool operator==(const iterator& a, const iterator& b) { return a.idx_ == b.idx_; }
+            friend bool operator!=(const iterator& a, const iterator& b) { return a.idx_ != b.idx_; }
+
+        private:
+            allocator* owner_ = nullptr;
+            size_t idx_ = NAlloc;
+        };
+
+        iterator begin() const {
+            return owner_->is_initialized() ? iterator{owner_, owner_->registry_.next_in_use(0u)} : end();
+        }
+        iterator end() const { return iterator{owner_, NAlloc}; }
+
+    private:
+        friend class allocator<TAlloc, NAlloc, Recycle>;
+
+        explicit live_range(allocator* owner) : owner_{owner} {}
+
+        allocator* owner_ = nullptr;
+    };
+    // End - Live range
+
     ~allocator() {
         deinitialize();
         std::free(storage_);
@@ -112,6 +191,13 @@ public:
 
     [[nodiscard]] constexpr bool is_initialized() const { return initialized_.load(std::memory_order_acquire); }
 
+    /**
+     * One step alternative to initialize(): builds an already initialized pool, see mp::pool.
+     */
+    [[nodiscard]] static auto create() -> std::expected<pool<TAlloc, NAlloc, Recycle>, result_t> {
+        return pool<TAlloc, NAlloc, Recycle>::create();
+    }
+
     /**
      * This is the first function to be called in order to reserve the system memory required by this pool.
      * It was designed to be used at runtime to provide flexibility to the client side instead to make it static
@@ -124,7 +210,17 @@ public:
         if (storage_ = static_cast<TAlloc*>(std::aligned_alloc(alignof(TAlloc), required_size_)); !storage_) {
             return result_t::unexp({code_e::cannot_reserve_system_memory});
         }
+        if constexpr (Recycle == recycle_e::warm) {
+            try {
+                std::uninitialized_value_construct(storage_, storage_ + NAlloc);
+            } catch (...) {
+                std::free(storage_);
+                storage_ = nullptr;
+                return result_t::unexp({code_e::exception_caught_in_ctor});
+            }
+        }
         initialized_.store(true, std::memory_order_release);
+        MP_PROBE(initialize, this, NAlloc, sizeof(TAlloc));
         return true;
     }
 
@@ -133,7 +229,12 @@ public:
      */
     void deinitialize() {
         if (is_initialized()) {
-            std::destroy(storage_, storage_ + NAlloc);
+            MP_PROBE(deinitialize, this, registry_.status().used);
+            if constexpr (Recycle == recycle_e::warm) {
+                std::destroy(storage_, storage_ + NAlloc);
+            } else {
+                registry_.for_each_in_use([this](size_t idx) { std::destroy_at(&storage_[idx]); });
+            }
         }
         initialized_.store(false, std::memory_order_release);
         registry_.reset();
@@ -141,34 +242,44 @@ public:
 
     /**
      * Allocates a new instance of TAlloc using its construction parameter is there is any.
+     * In recycle_e::warm mode the object is already constructed and handed back as left by TAlloc::reset(), no
+     * argument is accepted then.
      */
     template <typename... TArgs>
+        requires(Recycle == recycle_e::destroy || sizeof...(TArgs) == 0u)
     [[nodiscard]] constexpr auto allocate(TArgs&&... args) noexcept -> std::expected<TAlloc*, result_t> {
         if (!is_initialized()) {
+            stats_.failed(code_e::not_initialized);
             return result_t::unexp({code_e::not_initialized});
         }
-        if (const auto idx_result = registry_.fetch(); idx_result) {
-            try {
-                // Supposed to have only one index
-                const size_t first_free = (*idx_result).at(0u);
-
-                // TODO benchmark this allocation. As alternative this placement new can be done by
-                // initialize() with the default constructor, then here we create the object with
-                // the appropriate arguments and just move it to the position.
-                //
-                ::new (&storage_[first_free]) TAlloc{std::forward<TArgs>(args)...};
-                return &storage_[first_free];
-
-            } catch (const std::out_of_range& ex) {
-                return result_t::unexp({code_e::bad_logic, "Unable to access the fetched index"});
-            } catch (...) {
-                return result_t::unexp({code_e::exception_caught_in_ctor});
-            }
+        return allocate_impl(std::forward<TArgs>(args)...);
+    }
+
+    /**
+     * Unchecked fast path of allocate(): no std::expected and no state check, the allocator must be initialized
+     * (asserted in debug builds). Only available when constructing TAlloc cannot throw, so no exception handling
+     * code is generated around it.
+     * @return the new object, nullptr when there is no free slot
+     */
+    template <typename... TArgs>
+        requires(Recycle == recycle_e::destroy ? requires { { TAlloc{std::declval<TArgs>()...} } noexcept; }
+                                               : sizeof...(TArgs) == 0u)
+    [[nodiscard]] TAlloc* try_allocate(TArgs&&... args) noexcept {
+        assert(is_initialized());
+        [[maybe_unused]] const auto timer = latency_.time(detail::latency_recorder::op_e::allocate);
+
+        const size_t idx = fetch_one();
+        if (idx == NAlloc) [[unlikely]] {
+            return nullptr;
+        }
+        stats_.allocated(1u, registry_);
+        MP_PROBE(allocate, this, idx, registry_.status().used);
+
+        if constexpr (Recycle == recycle_e::destroy) {
+            return ::new (&storage_[idx]) TAlloc{std::forward<TArgs>(args)...};
         } else {
-            result_t error{idx_result.error()};
-            return result_t::unexp(std::move(error));
+            return &storage_[idx];
         }
-        return result_t::unexp({code_e::bad_logic});
     }
 
     /**
@@ -179,51 +290,312 @@ public:
         requires(SIZE > 0u)
     [[nodiscard]] constexpr auto allocate_bucket() noexcept -> std::expected<bucket<TAlloc*, NAlloc>, result_t> {
         if (!is_initialized()) {
+            stats_.failed(code_e::not_initialized);
             return result_t::unexp({code_e::not_initialized});
         }
+        return allocate_bucket_impl<SIZE>();
+    }
+
+    /**
+     * Deallocates a specif memory. In recycle_e::warm mode the object is not destroyed, TAlloc::reset() is called.
+     */
+    auto deallocate(TAlloc* allocated) noexcept -> std::expected<bool, result_t> {
+        if (!is_initialized()) {
+            stats_.failed(code_e::not_initialized);
+            return result_t::unexp({code_e::not_initialized});
+        }
+        return deallocate_impl(allocated);
+    }
+
+    /**
+     * Unchecked fast path of deallocate(): the pointer must come from this allocator and still be allocated
+     * (asserted in debug builds).
+     */
+    void deallocate_unchecked(TAlloc* allocated) noexcept
+        requires(Recycle == recycle_e::destroy ? std::is_nothrow_destructible_v<TAlloc>
+                                               : requires(TAlloc& obj) { { obj.reset() } noexcept; })
+    {
+        assert(is_initialized() && index_of(allocated) < NAlloc);
+        [[maybe_unused]] const auto timer = latency_.time(detail::latency_recorder::op_e::deallocate);
+
+        const auto idx = static_cast<size_t>(allocated - storage_);
+        if constexpr (Recycle == recycle_e::warm) {
+            allocated->reset();
+        } else {
+            std::destroy_at(allocated);
+        }
+        registry_.release_unchecked(idx);
+        stats_.deallocated();
+        MP_PROBE(deallocate, this, idx, registry_.status().used);
+    }
+
+    /**
+     * Deallocates the memory used by the Bucket array
+     */
+    auto deallocate(auto& the_bucket) noexcept -> std::expected<bool, result_t> {
+        for (auto ptr : the_bucket) {
+            if (auto result = deallocate(ptr); !result) {
+                return result;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Calls fn(TAlloc&) for every allocated object in address order. The occupancy bitmap is walked a word at a
+     * time so free regions cost almost nothing. When NPrefetchDistance is not zero the slot that many positions
+     * ahead is prefetched before each visit, which pays off when fn is short and the pool does not fit in cache.
+     * @return the number of visited objects
+     */
+    template <size_t NPrefetchDistance = 0u, typename TFn>
+        requires std::invocable<TFn&, TAlloc&>
+    auto for_each_live(TFn&& fn) -> std::expected<size_t, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        size_t visited{0u};
+
+        registry_.for_each_in_use([&](size_t idx) {
+            if constexpr (NPrefetchDistance > 0u) {
+                if (idx + NPrefetchDistance < NAlloc) {
+                    __builtin_prefetch(&storage_[idx + NPrefetchDistance]);
+                }
+            }
+            fn(storage_[idx]);
+            ++visited;
+        });
+        return visited;
+    }
+
+    /**
+     * Number of bitmap chunks of 512 slots, the unit of work of parallel_for_each_live() (parallel.hpp).
+     */
+    static constexpr size_t live_chunk_count = slot_status_registry<NAlloc>::chunk_count;
+
+    /**
+     * Calls fn(TAlloc&) for every allocated object of one chunk. Distinct chunks may be visited concurrently as long
+     * as the allocator itself is not modified meanwhile.
+     */
+    template <typename TFn>
+        requires std::invocable<TFn&, TAlloc&>
+    void for_each_live_in_chunk(size_t chunk, TFn&& fn) {
+        registry_.for_each_in_use_in_chunk(chunk, [&](size_t idx) { fn(storage_[idx]); });
+    }
+
+    /**
+     * Range of the allocated objects, empty when the allocator is not initialized.
+     */
+    [[nodiscard]] live_range live() { return live_range{this}; }
+
+    /**
+     * Slot of a pointer handed out by this allocator, NAlloc for any other pointer. With from_index() it lets
+     * containers link pooled objects by slot index instead of by pointer, see index_list.hpp.
+     */
+    [[nodiscard]] size_t index_of(const TAlloc* ptr) const {
+        const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        const auto first = reinterpret_cast<std::uintptr_t>(storage_);
+
+        if (address < first || address >= first + required_size_ || (address - first) % sizeof(TAlloc) != 0u) {
+            return NAlloc;
+        }
+        return (address - first) / sizeof(TAlloc);
+    }
+
+    /**
+     * Object in slot idx, unchecked: the allocator must be initialized and idx below NAlloc.
+     */
+    [[nodiscard]] TAlloc* from_index(size_t idx) const {
+        assert(is_initialized() && idx < NAlloc);
+        return &storage_[idx];
+    }
+
+    [[nodiscard]] auto status() const { return registry_.status(); }
+
+#if defined(MP_STATS)
+    /**
+     * Sums the per-thread counters, only available when built with MP_STATS.
+     */
+    [[nodiscard]] stats_t stats_snapshot() const { return stats_.snapshot(); }
+#endif
+
+#if defined(MP_LATENCY)
+    /**
+     * Merges the per-thread latency histograms of allocate() and deallocate(), only available when built with
+     * MP_LATENCY.
+     */
+    [[nodiscard]] latency_report_t latency_snapshot() const { return latency_.snapshot(); }
+#endif
+
+private:
+    friend class pool<TAlloc, NAlloc, Recycle>;
+
+    // Unchecked bodies of allocate(), allocate_bucket() and deallocate(), the storage must exist
+
+    template <typename... TArgs>
+    auto allocate_impl(TArgs&&... args) noexcept -> std::expected<TAlloc*, result_t> {
+        [[maybe_unused]] const auto timer = latency_.time(detail::latency_recorder::op_e::allocate);
+        const size_t idx = fetch_one();
+
+        if (idx == NAlloc) {
+            return result_t::unexp({code_e::not_enough_space_in_allocator});
+        }
+        if constexpr (Recycle == recycle_e::destroy) {
+            try {
+                ::new (&storage_[idx]) TAlloc{std::forward<TArgs>(args)...};
+            } catch (...) {
+                registry_.release(idx);
+                stats_.failed(code_e::exception_caught_in_ctor);
+                return result_t::unexp({code_e::exception_caught_in_ctor});
+            }
+        }
+        stats_.allocated(1u, registry_);
+        MP_PROBE(allocate, this, idx, registry_.status().used);
+        return &storage_[idx];
+    }
+
+    template <size_t SIZE>
+    auto allocate_bucket_impl() noexcept -> std::expected<bucket<TAlloc*, NAlloc>, result_t> {
         bucket<TAlloc*, NAlloc> bucket;
+        [[maybe_unused]] const size_t first_word = registry_.first_free_word();
 
-        if (auto frees = registry_.fetch(NAlloc); frees) {
-            for (auto&& i : *frees) {
+        if (auto frees = registry_.fetch(SIZE); frees) {
+            stats_.fetched(frees->back() / registry_.slots_per_word - first_word + 1u);
+
+            // On failure the objects built so far are destroyed and every fetched slot goes back to the registry
+            const auto rollback = [&](size_t built) noexcept {
+                if constexpr (Recycle == recycle_e::destroy) {
+                    for (size_t k = 0u; k < built; ++k) {
+                        std::destroy_at(&storage_[(*frees)[k]]);
+                    }
+                }
+                for (const size_t i : *frees) {
+                    registry_.release(i);
+                }
+            };
+            for (size_t k = 0u; k < frees->size(); ++k) {
+                const size_t i = (*frees)[k];
                 try {
-                    ::new (&storage_[i]) TAlloc{};
-                    if (!bucket.push_back(&storage_[i])) {
-                        return result_t::unexp({code_e::bad_logic, std::format("Cannot push into bucket index={}", i)});
+                    if constexpr (Recycle == recycle_e::destroy) {
+                        ::new (&storage_[i]) TAlloc{};
                     }
                 } catch (...) {
+                    rollback(k);
+                    stats_.failed(code_e::exception_caught_in_ctor);
                     return result_t::unexp({code_e::exception_caught_in_ctor});
                 }
+                if (!bucket.push_back(&storage_[i])) {
+                    rollback(k + 1u);
+                    stats_.failed(code_e::bad_logic);
+                    return result_t::unexp({code_e::bad_logic, error::describe("Cannot push into bucket index={}", i)});
+                }
             }
+            MP_PROBE(allocate_bucket, this, frees->front(), SIZE, registry_.status().used);
         } else {
+            stats_.failed(code_e::not_enough_space_in_allocator);
+            MP_PROBE(exhausted, this, SIZE, registry_.status().used);
             return result_t::unexp({code_e::not_enough_space_in_allocator});
         }
+        stats_.bucket_allocated();
+        stats_.allocated(SIZE, registry_);
         return bucket;
     }
 
-    /**
-     * Deallocates a specif memory
-     */
-    auto deallocate(TAlloc* allocated) noexcept -> std::expected<bool, result_t> {
-        if (!is_initialized()) {
-            return result_t::unexp({code_e::not_initialized});
-        }
-        for (size_t i = 0; i < NAlloc; ++i) {
-            if (allocated == &storage_[i]) {
-                try {
+    auto deallocate_impl(TAlloc* allocated) noexcept -> std::expected<bool, result_t> {
+        [[maybe_unused]] const auto timer = latency_.time(detail::latency_recorder::op_e::deallocate);
+        if (const auto i = index_of(allocated); i < NAlloc && registry_.in_use(i)) {
+            try {
+                if constexpr (Recycle == recycle_e::warm) {
+                    storage_[i].reset();
+                } else {
                     storage_[i].~TAlloc();
-                } catch (...) {
-                    return result_t::unexp({code_e::exception_caught_in_dctor});
                 }
-                storage_[i] = TAlloc{};
-                registry_.release(i);
+            } catch (...) {
+                stats_.failed(code_e::exception_caught_in_dctor);
+                return result_t::unexp({code_e::exception_caught_in_dctor});
             }
+            registry_.release(i);
+            stats_.deallocated();
+            MP_PROBE(deallocate, this, i, registry_.status().used);
         }
         return true;
     }
 
+    // registry_.try_fetch() plus the statistics about the scan, NAlloc when full
+    [[nodiscard]] size_t fetch_one() noexcept {
+        [[maybe_unused]] const size_t first_word = registry_.first_free_word();
+        const size_t idx = registry_.try_fetch();
+
+        if (idx == NAlloc) [[unlikely]] {
+            stats_.failed(code_e::not_enough_space_in_allocator);
+            MP_PROBE(exhausted, this, 1u, NAlloc);
+        } else {
+            stats_.fetched(idx / registry_.slots_per_word - first_word + 1u);
+        }
+        return idx;
+    }
+
+    static constexpr auto required_size_ = NAlloc * sizeof(TAlloc);
+    slot_status_registry<NAlloc> registry_;
+    std::atomic_bool initialized_ = false;
+    TAlloc* storage_ = nullptr;
+    [[no_unique_address]] detail::stats_recorder stats_;
+    [[no_unique_address]] detail::latency_recorder latency_;
+};
+
+/**
+ * Allocator that is initialized by construction: the only way to get one is create(), so every instance owns its
+ * storage and allocate(), allocate_bucket() and deallocate() skip the is_initialized() check. The memory goes back
+ * to the system on destruction. Movable, a moved-from pool must not be used anymore.
+ * mp::allocator and its two-phase initialize() remain available for the cases where the storage is reserved later.
+ */
+template <Allocatable TAlloc, size_t NAlloc, recycle_e Recycle>
+    requires(NAlloc > 0u && (Recycle == recycle_e::destroy || Recyclable<TAlloc>))
+class pool final {
+public:
+    using allocator_t = allocator<TAlloc, NAlloc, Recycle>;
+
+    [[nodiscard]] static auto create() -> std::expected<pool, result_t> {
+        std::unique_ptr<allocator_t> impl{new (std::nothrow) allocator_t{}};
+
+        if (!impl) {
+            return result_t::unexp({code_e::cannot_reserve_system_memory});
+        }
+        if (auto init = impl->initialize(); !init) {
+            result_t error{init.error()};
+            return result_t::unexp(std::move(error));
+        }
+        return pool{std::move(impl)};
+    }
+
+    pool(const pool&) = delete;
+    pool(pool&&) noexcept = default;
+    pool& operator=(const pool&) = delete;
+    pool& operator=(pool&&) noexcept = default;
+
     /**
-     * Deallocates the memory used by the Bucket array
+     * See allocator::allocate(), without the state check.
      */
+    template <typename... TArgs>
+        requires(Recycle == recycle_e::destroy || sizeof...(TArgs) == 0u)
+    [[nodiscard]] auto allocate(TArgs&&... args) noexcept -> std::expected<TAlloc*, result_t> {
+        return impl_->allocate_impl(std::forward<TArgs>(args)...);
+    }
+
+    template <typename... TArgs>
+    [[nodiscard]] TAlloc* try_allocate(TArgs&&... args) noexcept
+        requires requires(allocator_t& impl) { impl.try_allocate(std::forward<TArgs>(args)...); }
+    {
+        return impl_->try_allocate(std::forward<TArgs>(args)...);
+    }
+
+    template <size_t SIZE>
+        requires(SIZE > 0u)
+    [[nodiscard]] auto allocate_bucket() noexcept {
+        return impl_->template allocate_bucket_impl<SIZE>();
+    }
+
+    auto deallocate(TAlloc* allocated) noexcept -> std::expected<bool, result_t> { return impl_->deallocate_impl(allocated); }
+
     auto deallocate(auto& the_bucket) noexcept -> std::expected<bool, result_t> {
         for (auto ptr : the_bucket) {
             if (auto result = deallocate(ptr); !result) {
@@ -233,13 +605,44 @@ public:
         return true;
     }
 
-    [[nodiscard]] auto status() const { return registry_.status(); }
+    void deallocate_unchecked(TAlloc* allocated) noexcept
+        requires requires(allocator_t& impl) { impl.deallocate_unchecked(std::declval<TAlloc*>()); }
+    {
+        impl_->deallocate_unchecked(allocated);
+    }
+
+    template <size_t NPrefetchDistance = 0u, typename TFn>
+    auto for_each_live(TFn&& fn) {
+        return impl_->template for_each_live<NPrefetchDistance>(std::forward<TFn>(fn));
+    }
+
+    static constexpr size_t live_chunk_count = allocator_t::live_chunk_count;
+
+    template <typename TFn>
+    void for_each_live_in_chunk(size_t chunk, TFn&& fn) {
+        impl_->for_each_live_in_chunk(chunk, std::forward<TFn>(fn));
+    }
+
+    [[nodiscard]] auto live() { return impl_->live(); }
+
+    [[nodiscard]] size_t index_of(const TAlloc* ptr) const { return impl_->index_of(ptr); }
+
+    [[nodiscard]] TAlloc* from_index(size_t idx) const { return impl_->from_index(idx); }
+
+    [[nodiscard]] auto status() const { return impl_->status(); }
+
+#if defined(MP_STATS)
+    [[nodiscard]] stats_t stats_snapshot() const { return impl_->stats_snapshot(); }
+#endif
+
+#if defined(MP_LATENCY)
+    [[nodiscard]] latency_report_t latency_snapshot() const { return impl_->latency_snapshot(); }
+#endif
 
 private:
-    static constexpr auto required_size_ = NAlloc * sizeof(TAlloc);
-    slot_status_registry<NAlloc> registry_;
-    std::atomic_bool initialized_ = false;
-    TAlloc* storage_ = nullptr;
+    explicit pool(std::unique_ptr<allocator_t> impl) : impl_{std::move(impl)} {}
+
+    std::unique_ptr<allocator_t> impl_;
 };
 
 } // namespace mp
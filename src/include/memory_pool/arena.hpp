@@ -0,0 +1,135 @@
+
+#pragma once
+
+#include "bump_region.hpp"
+
+#include <cstddef>
+#include <expected>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace mp {
+
+using error::code_e;
+using error::result_t;
+
+/**
+ * Monotonic bump-pointer arena for temporaries of any type that all die together, e.g. the objects of a request.
+ * NBytes are reserved from the system by initialize() like mp::allocator does; allocate() and make() only move an
+ * offset forward and nothing is released individually. reset() gives the whole arena back at once: it runs the
+ * destructors registered by make(), which only registers the non-trivially destructible types, so it is O(1) for
+ * trivially destructible objects and raw bytes. Not thread safe.
+ */
+template <size_t NBytes>
+    requires(NBytes > 0u)
+class arena final {
+public:
+    struct status_t {
+        size_t used; //!< bytes, alignment padding and destructor records included
+        size_t free;
+    };
+
+    arena() = default;
+    arena(const arena&) = delete;
+    arena(arena&&) = delete;
+    arena& operator=(const arena&) = delete;
+    arena& operator=(arena&&) = delete;
+
+    ~arena() { deinitialize(); }
+
+    [[nodiscard]] constexpr bool is_initialized() const { return region_.is_reserved(); }
+
+    /**
+     * Reserves the NBytes of the arena, aligned on a cache line.
+     */
+    auto initialize() -> std::expected<bool, result_t> { return region_.reserve(); }
+
+    /**
+     * Destroys what is still alive, see reset(), and returns the memory to the system.
+     */
+    void deinitialize() {
+        reset();
+        region_.release();
+    }
+
+    /**
+     * Raw uninitialized bytes, align must be a power of two.
+     */
+    [[nodiscard]] auto allocate(size_t bytes, size_t align = alignof(std::max_align_t)) noexcept
+        -> std::expected<void*, result_t> {
+        return region_.allocate(bytes, align, "arena");
+    }
+
+    /**
+     * Constructs a T in the arena. Its destructor will run on reset() unless it is trivial, in which case nothing
+     * else than the object is stored.
+     */
+    template <typename T, typename... TArgs>
+        requires std::is_nothrow_destructible_v<T>
+    [[nodiscard]] auto make(TArgs&&... args) noexcept -> std::expected<T*, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        const size_t mark = region_.top();
+        finalizer_t* finalizer = nullptr;
+
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            if (finalizer = static_cast<finalizer_t*>(region_.bump(sizeof(finalizer_t), alignof(finalizer_t))); !finalizer) {
+                return result_t::unexp({code_e::not_enough_space_in_allocator});
+            }
+        }
+        void* ptr = region_.bump(sizeof(T), alignof(T));
+
+        if (!ptr) {
+            region_.rewind(mark);
+            return result_t::unexp({code_e::not_enough_space_in_allocator});
+        }
+        T* object = nullptr;
+        try {
+            object = ::new (ptr) T{std::forward<TArgs>(args)...};
+        } catch (...) {
+            region_.rewind(mark);
+            return result_t::unexp({code_e::exception_caught_in_ctor});
+        }
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            ::new (finalizer) finalizer_t{[](void* obj) noexcept { std::destroy_at(static_cast<T*>(obj)); }, object,
+                                          finalizers_};
+            finalizers_ = finalizer;
+        }
+        return object;
+    }
+
+    /**
+     * Destroys the objects made since the last reset, most recent first, and rewinds the arena. Every pointer handed
+     * out before is invalidated.
+     */
+    void reset() noexcept {
+        for (finalizer_t* finalizer = finalizers_; finalizer; finalizer = finalizer->next) {
+            finalizer->destroy(finalizer->object);
+        }
+        finalizers_ = nullptr;
+        region_.rewind(0u);
+    }
+
+    /**
+     * True when the pointer points inside the used part of the arena.
+     */
+    [[nodiscard]] bool owns(const void* ptr) const { return region_.owns(ptr); }
+
+    [[nodiscard]] status_t status() const { return status_t{.used = region_.top(), .free = NBytes - region_.top()}; }
+
+private:
+    // Written in the arena right before each object having a non-trivial destructor
+    struct finalizer_t {
+        void (*destroy)(void*) noexcept;
+        void* object;
+        finalizer_t* next;
+    };
+
+    detail::bump_region<NBytes> region_;
+    finalizer_t* finalizers_ = nullptr;
+};
+
+} // namespace mp
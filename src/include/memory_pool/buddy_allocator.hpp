@@ -0,0 +1,248 @@
+
+#pragma once
+
+#include "types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+
+namespace mp {
+
+using error::code_e;
+using error::result_t;
+
+/**
+ * Power-of-two variable-sized blocks, from NMinBlock to NMaxBlock bytes, carved out of one region of NRoots blocks
+ * of NMaxBlock bytes reserved by initialize(). A request is rounded up to the next power of two; a bigger free block
+ * is split in halves (buddies) until it has the right size, and a freed block merges with its buddy whenever the
+ * buddy is free too, so both operations are O(log(NMaxBlock / NMinBlock)).
+ * The free blocks of every size (order) are tracked in a bitmap laid out like slot_status_registry: 32 blocks per
+ * word, a free block is found with countr_zero and the words known to be empty are skipped. Every block is aligned
+ * on its size. Not thread safe.
+ */
+template <size_t NMinBlock, size_t NMaxBlock, size_t NRoots = 1u>
+    requires(std::has_single_bit(NMinBlock) && std::has_single_bit(NMaxBlock) && NMinBlock <= NMaxBlock && NRoots > 0u)
+class buddy_allocator final {
+public:
+    static constexpr size_t orders = static_cast<size_t>(std::countr_zero(NMaxBlock / NMinBlock)) + 1u;
+    static constexpr size_t capacity = NMaxBlock * NRoots;
+
+    struct status_t {
+        size_t used; //!< bytes of the allocated blocks, rounding included
+        size_t free;
+    };
+
+    buddy_allocator() = default;
+    buddy_allocator(const buddy_allocator&) = delete;
+    buddy_allocator(buddy_allocator&&) = delete;
+    buddy_allocator& operator=(const buddy_allocator&) = delete;
+    buddy_allocator& operator=(buddy_allocator&&) = delete;
+
+    ~buddy_allocator() { deinitialize(); }
+
+    [[nodiscard]] constexpr bool is_initialized() const { return storage_ != nullptr; }
+
+    /**
+     * Reserves the region, every root block is free.
+     */
+    auto initialize() -> std::expected<bool, result_t> {
+        if (is_initialized()) {
+            return result_t::unexp({code_e::already_initialized});
+        }
+        if (storage_ = static_cast<std::byte*>(std::aligned_alloc(NMaxBlock, capacity)); !storage_) {
+            return result_t::unexp({code_e::cannot_reserve_system_memory});
+        }
+        for (size_t root = 0u; root < NRoots; ++root) {
+            set_free(orders - 1u, root);
+        }
+        return true;
+    }
+
+    /**
+     * Returns the region to the system, every block handed out before is invalidated.
+     */
+    void deinitialize() {
+        std::free(storage_);
+        storage_ = nullptr;
+        free_.fill(0u);
+        first_free_word_.fill(0u);
+        free_count_.fill(0u);
+        order_of_.fill(0u);
+        used_ = 0u;
+    }
+
+    /**
+     * Uninitialized block of at least `bytes`, NMinBlock bytes for a zero size request.
+     */
+    [[nodiscard]] auto allocate(size_t bytes) noexcept -> std::expected<void*, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        if (bytes > NMaxBlock) {
+            return result_t::unexp({code_e::out_of_bounds, error::describe("buddy_allocator::allocate bytes={}", bytes)});
+        }
+        const size_t order = order_for(bytes);
+        size_t found = order;
+        size_t idx = npos_;
+
+        while (found < orders && (idx = take_free(found)) == npos_) {
+            ++found;
+        }
+        if (idx == npos_) {
+            return result_t::unexp({code_e::not_enough_space_in_allocator});
+        }
+        // Split down to the requested order, the upper halves stay free
+        while (found > order) {
+            --found;
+            idx *= 2u;
+            set_free(found, idx + 1u);
+        }
+        const size_t min_block = idx << order;
+        order_of_[min_block] = static_cast<std::uint8_t>(order + 1u);
+        used_ += NMinBlock << order;
+        return storage_ + min_block * NMinBlock;
+    }
+
+    /**
+     * Gives a block back and merges it with its free buddies.
+     */
+    auto deallocate(void* block) noexcept -> std::expected<bool, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        const size_t min_block = min_block_of(block);
+
+        if (min_block == min_blocks_ || order_of_[min_block] == 0u) {
+            return result_t::unexp({code_e::deallocation_has_failed,
+                                    error::describe("buddy_allocator::deallocate not allocated here block={}", block)});
+        }
+        size_t order = order_of_[min_block] - 1u;
+        size_t idx = min_block >> order;
+        order_of_[min_block] = 0u;
+        used_ -= NMinBlock << order;
+
+        while (order + 1u < orders && is_free(order, idx ^ 1u)) {
+            clear_free(order, idx ^ 1u);
+            idx /= 2u;
+            ++order;
+        }
+        set_free(order, idx);
+        return true;
+    }
+
+    /**
+     * Usable size of an allocated block, 0 for any other pointer.
+     */
+    [[nodiscard]] size_t block_size(const void* block) const {
+        const size_t min_block = min_block_of(block);
+        return min_block == min_blocks_ || order_of_[min_block] == 0u ? 0u : NMinBlock << (order_of_[min_block] - 1u);
+    }
+
+    /**
+     * Size of the biggest block allocate() can currently return, 0 when full. Compared with status().free it tells
+     * how fragmented the free space is.
+     */
+    [[nodiscard]] size_t largest_free_block() const {
+        for (size_t order = orders; order-- > 0u;) {
+            if (free_count_[order] != 0u) {
+                return NMinBlock << order;
+            }
+        }
+        return 0u;
+    }
+
+    /**
+     * Number of free blocks of exactly `block_size` bytes, 0 for a size that is not a block size.
+     */
+    [[nodiscard]] size_t free_blocks(size_t block_size) const {
+        if (!std::has_single_bit(block_size) || block_size < NMinBlock || block_size > NMaxBlock) {
+            return 0u;
+        }
+        return free_count_[order_for(block_size)];
+    }
+
+    [[nodiscard]] constexpr status_t status() const { return status_t{.used = used_, .free = capacity - used_}; }
+
+private:
+    static constexpr size_t bits_per_int_ = sizeof(unsigned int) * CHAR_BIT;
+    static constexpr size_t min_blocks_ = capacity / NMinBlock;
+    static constexpr size_t npos_ = min_blocks_;
+
+    static constexpr size_t blocks_at(size_t order) { return NRoots << (orders - 1u - order); }
+    static constexpr size_t words_at(size_t order) { return (blocks_at(order) + bits_per_int_ - 1u) / bits_per_int_; }
+
+    // The bitmaps of all the orders share one array, order 0 (the smallest blocks) first
+    static constexpr auto word_offsets_ = [] {
+        std::array<size_t, orders + 1u> offsets{};
+        for (size_t order = 0u; order < orders; ++order) {
+            offsets[order + 1u] = offsets[order] + words_at(order);
+        }
+        return offsets;
+    }();
+
+    static constexpr size_t order_for(size_t bytes) {
+        return static_cast<size_t>(std::countr_zero(std::bit_ceil(std::max(bytes, NMinBlock)) / NMinBlock));
+    }
+
+    [[nodiscard]] bool is_free(size_t order, size_t idx) const {
+        return (free_[word_offsets_[order] + idx / bits_per_int_] & (1u << (idx % bits_per_int_))) != 0u;
+    }
+
+    void set_free(size_t order, size_t idx) {
+        assert(!is_free(order, idx));
+        free_[word_offsets_[order] + idx / bits_per_int_] |= 1u << (idx % bits_per_int_);
+        first_free_word_[order] = std::min(first_free_word_[order], idx / bits_per_int_);
+        ++free_count_[order];
+    }
+
+    void clear_free(size_t order, size_t idx) {
+        assert(is_free(order, idx));
+        free_[word_offsets_[order] + idx / bits_per_int_] &= ~(1u << (idx % bits_per_int_));
+        --free_count_[order];
+    }
+
+    // Removes and returns the first free block of the order, npos_ when there is none
+    [[nodiscard]] size_t take_free(size_t order) {
+        if (free_count_[order] == 0u) {
+            return npos_;
+        }
+        for (size_t word = first_free_word_[order]; word < words_at(order); ++word) {
+            if (const unsigned int bits = free_[word_offsets_[order] + word]; bits != 0u) {
+                const size_t idx = word * bits_per_int_ + static_cast<size_t>(std::countr_zero(bits));
+                first_free_word_[order] = word;
+                clear_free(order, idx);
+                return idx;
+            }
+        }
+        assert(false && "free_count_ out of sync with the bitmap");
+        return npos_;
+    }
+
+    // Index in NMinBlock units of a block handed out by this allocator, min_blocks_ for any other pointer
+    [[nodiscard]] size_t min_block_of(const void* ptr) const {
+        const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        const auto first = reinterpret_cast<std::uintptr_t>(storage_);
+
+        if (!storage_ || address < first || address >= first + capacity || (address - first) % NMinBlock != 0u) {
+            return min_blocks_;
+        }
+        return (address - first) / NMinBlock;
+    }
+
+    std::byte* storage_ = nullptr;
+    std::array<unsigned int, word_offsets_[orders]> free_{};
+    std::array<size_t, orders> first_free_word_{};
+    std::array<size_t, orders> free_count_{};
+    // 1 + order of the allocated block starting at each NMinBlock unit, 0 when no allocated block starts there
+    std::array<std::uint8_t, min_blocks_> order_of_{};
+    size_t used_{0u};
+};
+
+} // namespace mp
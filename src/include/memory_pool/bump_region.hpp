@@ -0,0 +1,113 @@
+
+#pragma once
+
+#include "types.hpp"
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+#include <string_view>
+
+namespace mp::detail {
+
+using error::code_e;
+using error::result_t;
+
+/**
+ * NBytes reserved from the system and handed out by moving an offset forward, the storage of arena and
+ * stack_allocator. Nothing is released individually, the owner moves the top back with rewind(). Not thread safe.
+ */
+template <size_t NBytes>
+    requires(NBytes > 0u)
+class bump_region final {
+public:
+    bump_region() = default;
+    bump_region(const bump_region&) = delete;
+    bump_region(bump_region&&) = delete;
+    bump_region& operator=(const bump_region&) = delete;
+    bump_region& operator=(bump_region&&) = delete;
+
+    ~bump_region() { release(); }
+
+    [[nodiscard]] constexpr bool is_reserved() const { return storage_ != nullptr; }
+
+    /**
+     * Reserves the NBytes, aligned on a cache line.
+     */
+    auto reserve() -> std::expected<bool, result_t> {
+        if (is_reserved()) {
+            return result_t::unexp({code_e::already_initialized});
+        }
+        if (storage_ = static_cast<std::byte*>(std::aligned_alloc(cache_line_size, required_size_)); !storage_) {
+            return result_t::unexp({code_e::cannot_reserve_system_memory});
+        }
+        return true;
+    }
+
+    /**
+     * Returns the memory to the system.
+     */
+    void release() {
+        std::free(storage_);
+        storage_ = nullptr;
+        top_ = 0u;
+    }
+
+    /**
+     * Checked allocation of raw bytes for the owner's allocate(), align must be a power of two. owner names the
+     * caller in the error description.
+     */
+    [[nodiscard]] auto allocate(size_t bytes, size_t align, std::string_view owner) noexcept
+        -> std::expected<void*, result_t> {
+        if (!is_reserved()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        if (!std::has_single_bit(align)) {
+            return result_t::unexp({code_e::bad_logic, error::describe("{}::allocate align={}", owner, align)});
+        }
+        if (void* ptr = bump(bytes, align); ptr) {
+            return ptr;
+        }
+        return result_t::unexp({code_e::not_enough_space_in_allocator});
+    }
+
+    // Aligned start of the next bytes, nullptr when they do not fit
+    [[nodiscard]] void* bump(size_t bytes, size_t align) noexcept {
+        const auto first = reinterpret_cast<std::uintptr_t>(storage_);
+        const size_t begin = ((first + top_ + align - 1u) & ~(align - 1u)) - first;
+
+        if (begin > NBytes || bytes > NBytes - begin) [[unlikely]] {
+            return nullptr;
+        }
+        top_ = begin + bytes;
+        return storage_ + begin;
+    }
+
+    [[nodiscard]] size_t top() const { return top_; }
+
+    // Releases everything above offset, which must not be above top()
+    void rewind(size_t offset) {
+        assert(offset <= top_);
+        top_ = offset;
+    }
+
+    /**
+     * True when the pointer points inside the used part of the region.
+     */
+    [[nodiscard]] bool owns(const void* ptr) const {
+        const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        const auto first = reinterpret_cast<std::uintptr_t>(storage_);
+        return storage_ && address >= first && address < first + top_;
+    }
+
+private:
+    // std::aligned_alloc() wants a multiple of the alignment
+    static constexpr size_t required_size_ = (NBytes + cache_line_size - 1u) / cache_line_size * cache_line_size;
+    std::byte* storage_ = nullptr;
+    size_t top_{0u};
+};
+
+} // namespace mp::detail
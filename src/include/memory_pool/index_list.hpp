@@ -0,0 +1,331 @@
+
+#pragma once
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+namespace mp {
+
+/**
+ * Narrowest unsigned integer holding every slot index of an NAlloc slots allocator plus the "no slot" value:
+ * 16 bits below 65536 slots, 32 bits otherwise.
+ */
+template <size_t NAlloc>
+    requires(NAlloc > 0u && NAlloc < std::numeric_limits<std::uint32_t>::max())
+using slot_index_t =
+    std::conditional_t<(NAlloc <= std::numeric_limits<std::uint16_t>::max()), std::uint16_t, std::uint32_t>;
+
+/**
+ * End of a chain of slot indexes.
+ */
+template <size_t NAlloc>
+inline constexpr slot_index_t<NAlloc> no_slot = std::numeric_limits<slot_index_t<NAlloc>>::max();
+
+/**
+ * Link embedded in an object to put it in an index_stack or an index_queue.
+ */
+template <size_t NAlloc>
+struct slist_hook_t {
+    slot_index_t<NAlloc> next{no_slot<NAlloc>};
+};
+
+/**
+ * Links embedded in an object to put it in an index_list.
+ */
+template <size_t NAlloc>
+struct list_hook_t {
+    slot_index_t<NAlloc> next{no_slot<NAlloc>};
+    slot_index_t<NAlloc> prev{no_slot<NAlloc>};
+};
+
+/**
+ * What an index container needs from the owner of the slots: mp::allocator and mp::pool.
+ */
+template <typename TSlots, typename TAlloc>
+concept SlotIndexed = requires(const TSlots& slots, const TAlloc* ptr, size_t idx) {
+    { slots.index_of(ptr) } -> std::same_as<size_t>;
+    { slots.from_index(idx) } -> std::same_as<TAlloc*>;
+};
+
+} // namespace mp
+
+namespace mp::detail {
+
+/**
+ * Storage of the slots an index container links, captured once so a link is followed with an addition and an
+ * object is located with a subtraction.
+ */
+template <typename TAlloc, size_t NAlloc>
+class slot_base {
+public:
+    using index_t = slot_index_t<NAlloc>;
+
+    template <SlotIndexed<TAlloc> TSlots>
+    explicit slot_base(const TSlots& slots) : base_{slots.from_index(0u)} {}
+
+    [[nodiscard]] TAlloc& node(index_t idx) const {
+        assert(idx < NAlloc);
+        return base_[idx];
+    }
+
+    [[nodiscard]] index_t index(const TAlloc& obj) const {
+        assert(&obj >= base_ && &obj < base_ + NAlloc);
+        return static_cast<index_t>(&obj - base_);
+    }
+
+private:
+    TAlloc* base_;
+};
+
+/**
+ * Forward iterator following the next links of a Hook.
+ */
+template <typename TAlloc, size_t NAlloc, auto Hook>
+class index_iterator final {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = TAlloc;
+    using pointer = TAlloc*;
+    using reference = TAlloc&;
+
+    index_iterator() = default;
+    index_iterator(const slot_base<TAlloc, NAlloc>* slots, slot_index_t<NAlloc> idx) : slots_{slots}, idx_{idx} {}
+
+    reference operator*() const { return slots_->node(idx_); }
+    pointer operator->() const { return &slots_->node(idx_); }
+
+    index_iterator& operator++() {
+        idx_ = (slots_->node(idx_).*Hook).next;
+        return *this;
+    }
+
+    index_iterator operator++(int) {
+        index_iterator tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    friend bool operator==(const index_iterator& a, const index_iterator& b) { return a.idx_ == b.idx_; }
+
+private:
+    const slot_base<TAlloc, NAlloc>* slots_ = nullptr;
+    slot_index_t<NAlloc> idx_ = no_slot<NAlloc>;
+};
+
+} // namespace mp::detail
+
+namespace mp {
+
+/**
+ * Intrusive LIFO of objects living in the slots of an allocator (or pool). The link is the slist_hook_t member Hook
+ * of the object and holds a 16 or 32-bit slot index instead of a pointer. The stack does not own its objects: they
+ * must stay allocated while linked, an object is in at most one container per hook, and the allocator must stay
+ * initialized as long as the stack is used.
+ */
+template <typename TAlloc, size_t NAlloc, slist_hook_t<NAlloc> TAlloc::*Hook>
+class index_stack final : detail::slot_base<TAlloc, NAlloc> {
+    using base_t = detail::slot_base<TAlloc, NAlloc>;
+
+public:
+    using iterator = detail::index_iterator<TAlloc, NAlloc, Hook>;
+
+    using base_t::base_t;
+
+    void push(TAlloc& obj) {
+        (obj.*Hook).next = top_;
+        top_ = this->index(obj);
+        ++size_;
+    }
+
+    // nullptr when empty
+    TAlloc* pop() {
+        if (empty()) {
+            return nullptr;
+        }
+        TAlloc& obj = this->node(top_);
+        top_ = (obj.*Hook).next;
+        --size_;
+        return &obj;
+    }
+
+    [[nodiscard]] TAlloc* top() const { return empty() ? nullptr : &this->node(top_); }
+
+    [[nodiscard]] bool empty() const { return top_ == no_slot<NAlloc>; }
+    [[nodiscard]] size_t size() const { return size_; }
+
+    // Unlinks every object, none is deallocated
+    void clear() {
+        top_ = no_slot<NAlloc>;
+        size_ = 0u;
+    }
+
+    [[nodiscard]] iterator begin() const { return iterator{this, top_}; }
+    [[nodiscard]] iterator end() const { return iterator{this, no_slot<NAlloc>}; }
+
+private:
+    slot_index_t<NAlloc> top_{no_slot<NAlloc>};
+    size_t size_{0u};
+};
+
+/**
+ * Intrusive FIFO of objects living in the slots of an allocator (or pool), linked like index_stack through an
+ * slist_hook_t member.
+ */
+template <typename TAlloc, size_t NAlloc, slist_hook_t<NAlloc> TAlloc::*Hook>
+class index_queue final : detail::slot_base<TAlloc, NAlloc> {
+    using base_t = detail::slot_base<TAlloc, NAlloc>;
+
+public:
+    using iterator = detail::index_iterator<TAlloc, NAlloc, Hook>;
+
+    using base_t::base_t;
+
+    void push(TAlloc& obj) {
+        const auto idx = this->index(obj);
+
+        (obj.*Hook).next = no_slot<NAlloc>;
+        if (empty()) {
+            head_ = idx;
+        } else {
+            (this->node(tail_).*Hook).next = idx;
+        }
+        tail_ = idx;
+        ++size_;
+    }
+
+    // nullptr when empty
+    TAlloc* pop() {
+        if (empty()) {
+            return nullptr;
+        }
+        TAlloc& obj = this->node(head_);
+        head_ = (obj.*Hook).next;
+        if (head_ == no_slot<NAlloc>) {
+            tail_ = no_slot<NAlloc>;
+        }
+        --size_;
+        return &obj;
+    }
+
+    [[nodiscard]] TAlloc* front() const { return empty() ? nullptr : &this->node(head_); }
+    [[nodiscard]] TAlloc* back() const { return empty() ? nullptr : &this->node(tail_); }
+
+    [[nodiscard]] bool empty() const { return head_ == no_slot<NAlloc>; }
+    [[nodiscard]] size_t size() const { return size_; }
+
+    // Unlinks every object, none is deallocated
+    void clear() {
+        head_ = tail_ = no_slot<NAlloc>;
+        size_ = 0u;
+    }
+
+    [[nodiscard]] iterator begin() const { return iterator{this, head_}; }
+    [[nodiscard]] iterator end() const { return iterator{this, no_slot<NAlloc>}; }
+
+private:
+    slot_index_t<NAlloc> head_{no_slot<NAlloc>};
+    slot_index_t<NAlloc> tail_{no_slot<NAlloc>};
+    size_t size_{0u};
+};
+
+/**
+ * Intrusive doubly linked list of objects living in the slots of an allocator (or pool), linked through a
+ * list_hook_t member: 4 bytes per object below 65536 slots, 8 bytes otherwise, where std::list adds two pointers
+ * and a heap block per element. Any linked object is unlinked in constant time with erase().
+ */
+template <typename TAlloc, size_t NAlloc, list_hook_t<NAlloc> TAlloc::*Hook>
+class index_list final : detail::slot_base<TAlloc, NAlloc> {
+    using base_t = detail::slot_base<TAlloc, NAlloc>;
+    using index_t = slot_index_t<NAlloc>;
+
+public:
+    using iterator = detail::index_iterator<TAlloc, NAlloc, Hook>;
+
+    using base_t::base_t;
+
+    void push_front(TAlloc& obj) { link(obj, no_slot<NAlloc>, head_); }
+    void push_back(TAlloc& obj) { link(obj, tail_, no_slot<NAlloc>); }
+
+    /**
+     * Links obj in front of pos, at the back when pos is end().
+     */
+    void insert(iterator pos, TAlloc& obj) {
+        if (pos == end()) {
+            push_back(obj);
+        } else {
+            link(obj, ((*pos).*Hook).prev, this->index(*pos));
+        }
+    }
+
+    // nullptr when empty
+    TAlloc* pop_front() { return empty() ? nullptr : &erase(this->node(head_)); }
+    TAlloc* pop_back() { return empty() ? nullptr : &erase(this->node(tail_)); }
+
+    /**
+     * Unlinks an object of this list, it stays allocated.
+     */
+    TAlloc& erase(TAlloc& obj) {
+        auto& hook = obj.*Hook;
+
+        if (hook.prev == no_slot<NAlloc>) {
+            head_ = hook.next;
+        } else {
+            (this->node(hook.prev).*Hook).next = hook.next;
+        }
+        if (hook.next == no_slot<NAlloc>) {
+            tail_ = hook.prev;
+        } else {
+            (this->node(hook.next).*Hook).prev = hook.prev;
+        }
+        hook.next = hook.prev = no_slot<NAlloc>;
+        --size_;
+        return obj;
+    }
+
+    [[nodiscard]] TAlloc* front() const { return empty() ? nullptr : &this->node(head_); }
+    [[nodiscard]] TAlloc* back() const { return empty() ? nullptr : &this->node(tail_); }
+
+    [[nodiscard]] bool empty() const { return head_ == no_slot<NAlloc>; }
+    [[nodiscard]] size_t size() const { return size_; }
+
+    // Unlinks every object, none is deallocated
+    void clear() {
+        head_ = tail_ = no_slot<NAlloc>;
+        size_ = 0u;
+    }
+
+    [[nodiscard]] iterator begin() const { return iterator{this, head_}; }
+    [[nodiscard]] iterator end() const { return iterator{this, no_slot<NAlloc>}; }
+
+private:
+    void link(TAlloc& obj, index_t prev, index_t next) {
+        const index_t idx = this->index(obj);
+        auto& hook = obj.*Hook;
+
+        hook.prev = prev;
+        hook.next = next;
+        if (prev == no_slot<NAlloc>) {
+            head_ = idx;
+        } else {
+            (this->node(prev).*Hook).next = idx;
+        }
+        if (next == no_slot<NAlloc>) {
+            tail_ = idx;
+        } else {
+            (this->node(next).*Hook).prev = idx;
+        }
+        ++size_;
+    }
+
+    index_t head_{no_slot<NAlloc>};
+    index_t tail_{no_slot<NAlloc>};
+    size_t size_{0u};
+};
+
+} // namespace mp
@@ -0,0 +1,241 @@
+
+#pragma once
+
+#include "slot_status_registry.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+#include <mutex>
+#include <span>
+#include <utility>
+
+#include <sys/uio.h>
+
+namespace mp {
+
+using error::code_e;
+using error::result_t;
+
+/**
+ * Block sizes of io_buffer_pool: 2, 4, 16 or 64 KB.
+ */
+template <size_t N>
+concept IoBlockSize = N == 2048u || N == 4096u || N == 16384u || N == 65536u;
+
+/**
+ * Pool of fixed-size byte buffers for the network layer. The blocks are carved out of one page-aligned region
+ * (so every block of 4 KB and more starts on a page) and handed out as reference counted handles: copying a buffer
+ * shares the block, e.g. to queue the same payload on several connections, and the block goes back to the pool
+ * with the last handle. The buffers export iovec arrays so readv(), writev() and sendmsg() work on the pooled
+ * memory directly. acquire() and the handles are thread safe, so the copies of a buffer can be handed to
+ * connections served by other threads: the reference counts are atomic and the registry is guarded by a mutex.
+ * The bytes of a block are not, they must be written before the buffer is shared.
+ */
+template <size_t NBlockSize, size_t NBlocks>
+    requires(IoBlockSize<NBlockSize> && NBlocks > 0u)
+class io_buffer_pool final {
+public:
+    static constexpr size_t block_size = NBlockSize;
+    static constexpr size_t page_size = 4096u;
+
+    /**
+     * Handle on a block: the bytes [data(), data() + size()) are filled, the rest up to capacity() is free.
+     */
+    class buffer final {
+    public:
+        buffer() = default;
+        buffer(const buffer& other) : pool_{other.pool_}, idx_{other.idx_}, size_{other.size_} {
+            if (pool_) {
+                pool_->refcounts_[idx_].fetch_add(1u, std::memory_order_relaxed);
+            }
+        }
+        buffer(buffer&& other) noexcept
+            : pool_{std::exchange(other.pool_, nullptr)}, idx_{other.idx_}, size_{std::exchange(other.size_, 0u)} {}
+        buffer& operator=(buffer other) noexcept {
+            std::swap(pool_, other.pool_);
+            std::swap(idx_, other.idx_);
+            std::swap(size_, other.size_);
+            return *this;
+        }
+        ~buffer() { reset(); }
+
+        /**
+         * Drops this reference, the block is released with the last one.
+         */
+        void reset() {
+            if (pool_) {
+                pool_->unref(idx_);
+                pool_ = nullptr;
+                size_ = 0u;
+            }
+        }
+
+        [[nodiscard]] explicit operator bool() const { return pool_ != nullptr; }
+
+        [[nodiscard]] std::byte* data() const { return pool_ ? pool_->block_at(idx_) : nullptr; }
+        [[nodiscard]] size_t size() const { return size_; }
+        [[nodiscard]] static constexpr size_t capacity() { return NBlockSize; }
+
+        /**
+         * Filled bytes, what writev() sends.
+         */
+        [[nodiscard]] std::span<std::byte> readable() const { return {data(), size_}; }
+
+        /**
+         * Free bytes after the filled ones, what readv() fills. The block is shared with the other copies of the
+         * handle, so it should only be written while use_count() is 1.
+         */
+        [[nodiscard]] std::span<std::byte> writable() const { return {data() + size_, pool_ ? NBlockSize - size_ : 0u}; }
+
+        /**
+         * Sets how many bytes are filled, clamped to the capacity. Each handle has its own size, so a copy can
+         * send a prefix of the block.
+         */
+        void resize(size_t size) { size_ = std::min(size, pool_ ? NBlockSize : 0u); }
+
+        [[nodiscard]] std::uint32_t use_count() const {
+            return pool_ ? pool_->refcounts_[idx_].load(std::memory_order_relaxed) : 0u;
+        }
+
+    private:
+        friend class io_buffer_pool;
+
+        buffer(io_buffer_pool* pool, size_t idx) : pool_{pool}, idx_{idx} {}
+
+        io_buffer_pool* pool_ = nullptr;
+        size_t idx_{0u};
+        size_t size_{0u};
+    };
+
+    io_buffer_pool() = default;
+    io_buffer_pool(const io_buffer_pool&) = delete;
+    io_buffer_pool(io_buffer_pool&&) = delete;
+    io_buffer_pool& operator=(const io_buffer_pool&) = delete;
+    io_buffer_pool& operator=(io_buffer_pool&&) = delete;
+
+    ~io_buffer_pool() { deinitialize(); }
+
+    [[nodiscard]] constexpr bool is_initialized() const { return initialized_.load(std::memory_order_acquire); }
+
+    /**
+     * Reserves the NBlocks blocks in one page-aligned region.
+     */
+    auto initialize() -> std::expected<bool, result_t> {
+        if (is_initialized()) {
+            return result_t::unexp({code_e::already_initialized});
+        }
+        if (storage_ = static_cast<std::byte*>(std::aligned_alloc(page_size, required_size_)); !storage_) {
+            return result_t::unexp({code_e::cannot_reserve_system_memory});
+        }
+        initialized_.store(true, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Returns the memory to the system, no buffer may be alive anymore.
+     */
+    void deinitialize() {
+        assert(registry_.status().used == 0u && "io_buffer_pool deinitialized with live buffers");
+        initialized_.store(false, std::memory_order_release);
+        registry_.reset();
+        std::free(storage_);
+        storage_ = nullptr;
+    }
+
+    /**
+     * An empty buffer on a free block.
+     */
+    [[nodiscard]] auto acquire() noexcept -> std::expected<buffer, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        size_t idx{NBlocks};
+        {
+            std::lock_guard lock{mutex_};
+            idx = registry_.try_fetch();
+        }
+        if (idx == NBlocks) {
+            return result_t::unexp({code_e::not_enough_space_in_allocator});
+        }
+        refcounts_[idx].store(1u, std::memory_order_relaxed);
+        return buffer{this, idx};
+    }
+
+    /**
+     * Fills `out` with the filled bytes of the buffers, for writev() / sendmsg().
+     * @return the number of iovec written, at most out.size(); empty buffers are skipped
+     */
+    static size_t readable_iovecs(std::span<const buffer> buffers, std::span<iovec> out) {
+        size_t count{0u};
+        for (const buffer& buf : buffers) {
+            if (count == out.size()) {
+                break;
+            }
+            if (buf.size() != 0u) {
+                out[count++] = iovec{.iov_base = buf.data(), .iov_len = buf.size()};
+            }
+        }
+        return count;
+    }
+
+    /**
+     * Fills `out` with the free bytes of the buffers, for readv() / recvmsg().
+     * @return the number of iovec written, at most out.size(); full buffers are skipped
+     */
+    static size_t writable_iovecs(std::span<const buffer> buffers, std::span<iovec> out) {
+        size_t count{0u};
+        for (const buffer& buf : buffers) {
+            if (count == out.size()) {
+                break;
+            }
+            if (const auto free = buf.writable(); !free.empty()) {
+                out[count++] = iovec{.iov_base = free.data(), .iov_len = free.size()};
+            }
+        }
+        return count;
+    }
+
+    /**
+     * Accounts for `bytes` received by a readv() on writable_iovecs(): the buffers are filled in order.
+     * @return the bytes that did not fit, 0 unless `bytes` is more than the free space
+     */
+    static size_t commit(std::span<buffer> buffers, size_t bytes) {
+        for (buffer& buf : buffers) {
+            const size_t taken = std::min(bytes, buf.writable().size());
+            buf.resize(buf.size() + taken);
+            bytes -= taken;
+        }
+        return bytes;
+    }
+
+    [[nodiscard]] auto status() const { return registry_.status(); }
+
+private:
+    [[nodiscard]] std::byte* block_at(size_t idx) const { return storage_ + idx * NBlockSize; }
+
+    // acq_rel: the last owner sees every access made through the other copies before the block is reused
+    void unref(size_t idx) {
+        const std::uint32_t previous = refcounts_[idx].fetch_sub(1u, std::memory_order_acq_rel);
+        assert(previous != 0u);
+        if (previous == 1u) {
+            std::lock_guard lock{mutex_};
+            registry_.release_unchecked(idx);
+        }
+    }
+
+    // std::aligned_alloc() wants a multiple of the alignment
+    static constexpr size_t required_size_ = (NBlockSize * NBlocks + page_size - 1u) / page_size * page_size;
+    std::mutex mutex_;
+    slot_status_registry<NBlocks> registry_;
+    std::array<std::atomic_uint32_t, NBlocks> refcounts_{};
+    std::atomic_bool initialized_ = false;
+    std::byte* storage_ = nullptr;
+};
+
+} // namespace mp
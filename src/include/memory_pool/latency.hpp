@@ -0,0 +1,288 @@
+
+#pragma once
+
+#include "stats.hpp"
+#include "types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <time.h>
+#include <unistd.h>
+#if defined(MP_LATENCY_TSC)
+    #include <x86intrin.h>
+#endif
+
+namespace mp::detail {
+
+class latency_shard;
+
+} // namespace mp::detail
+
+namespace mp {
+
+/**
+ * Log-linear histogram in the spirit of HdrHistogram: values below 32 get their own bucket, above that every power
+ * of two is split in 16 buckets, so any value is known within ~6% over the whole 64 bits range.
+ */
+class latency_histogram {
+public:
+    static constexpr std::size_t sub_bucket_bits = 5u;
+    static constexpr std::size_t sub_bucket_count = std::size_t{1u} << sub_bucket_bits;
+    static constexpr std::size_t half_count = sub_bucket_count / 2u;
+    static constexpr std::size_t bucket_count = sub_bucket_count + (64u - sub_bucket_bits) * half_count;
+
+    static constexpr std::size_t bucket_of(std::uint64_t value) {
+        if (value < sub_bucket_count) {
+            return static_cast<std::size_t>(value);
+        }
+        const auto shift = static_cast<std::size_t>(std::bit_width(value)) - sub_bucket_bits;
+        return sub_bucket_count + (shift - 1u) * half_count + static_cast<std::size_t>((value >> shift) - half_count);
+    }
+
+    /**
+     * Highest value falling in the given bucket.
+     */
+    static constexpr std::uint64_t upper_bound_of(std::size_t bucket) {
+        if (bucket < sub_bucket_count) {
+            return bucket;
+        }
+        const std::size_t shift = (bucket - sub_bucket_count) / half_count + 1u;
+        const std::uint64_t top = (bucket - sub_bucket_count) % half_count + half_count;
+        return ((top + 1u) << shift) - 1u;
+    }
+
+    void record(std::uint64_t value, std::uint64_t count = 1u) {
+        counts_[bucket_of(value)] += count;
+        total_ += count;
+        sum_ += value * count;
+        max_ = std::max(max_, value);
+        min_ = std::min(min_, value);
+    }
+
+    void merge(const latency_histogram& other) {
+        for (std::size_t i = 0u; i < bucket_count; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        sum_ += other.sum_;
+        max_ = std::max(max_, other.max_);
+        min_ = std::min(min_, other.min_);
+    }
+
+    /**
+     * Smallest recorded value bound such that `percentile` percent of the samples are at or below it.
+     */
+    [[nodiscard]] std::uint64_t percentile(double percentile) const {
+        if (total_ == 0u) {
+            return 0u;
+        }
+        const double fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+        const auto rank = static_cast<std::uint64_t>(static_cast<double>(total_) * fraction);
+        std::uint64_t seen{0u};
+
+        for (std::size_t i = 0u; i < bucket_count; ++i) {
+            seen += counts_[i];
+            if (seen > rank || seen == total_) {
+                return std::min(upper_bound_of(i), max_);
+            }
+        }
+        return max_;
+    }
+
+    [[nodiscard]] std::uint64_t count() const { return total_; }
+    [[nodiscard]] std::uint64_t max() const { return max_; }
+    [[nodiscard]] std::uint64_t min() const { return total_ == 0u ? 0u : min_; }
+    [[nodiscard]] double mean() const {
+        return total_ == 0u ? 0.0 : static_cast<double>(sum_) / static_cast<double>(total_);
+    }
+
+private:
+    friend class detail::latency_shard;
+
+    std::array<std::uint64_t, bucket_count> counts_{};
+    std::uint64_t total_{0u};
+    std::uint64_t sum_{0u};
+    std::uint64_t max_{0u};
+    std::uint64_t min_{~std::uint64_t{0u}};
+};
+
+/**
+ * Merged latencies of an allocator, see allocator::latency_snapshot().
+ */
+struct latency_report_t {
+#if defined(MP_LATENCY_TSC)
+    static constexpr std::string_view unit = "ticks";
+#else
+    static constexpr std::string_view unit = "ns";
+#endif
+
+    latency_histogram allocate;
+    latency_histogram deallocate;
+
+    void merge(const latency_report_t& other) {
+        allocate.merge(other.allocate);
+        deallocate.merge(other.deallocate);
+    }
+
+    [[nodiscard]] std::string to_string() const {
+        std::string out;
+        for (const auto& [name, histogram] : {std::pair{"allocate", &allocate}, std::pair{"deallocate", &deallocate}}) {
+            out += std::format("{}: count={} min={} mean={:.1f} p50={} p99={} p99.9={} max={} ({})\n", name,
+                               histogram->count(), histogram->min(), histogram->mean(), histogram->percentile(50.0),
+                               histogram->percentile(99.0), histogram->percentile(99.9), histogram->max(), unit);
+        }
+        return out;
+    }
+
+    /**
+     * Writes the report to a file descriptor.
+     * @return false if the descriptor did not accept the whole report
+     */
+    bool write(int fd) const {
+        const std::string out = to_string();
+        std::size_t written{0u};
+
+        while (written < out.size()) {
+            const auto n = ::write(fd, out.data() + written, out.size() - written);
+            if (n <= 0) {
+                return false;
+            }
+            written += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+};
+
+namespace detail {
+
+/**
+ * Timestamp used by the latency instrumentation: the TSC with MP_LATENCY_TSC (cheapest, in cycles), otherwise
+ * CLOCK_MONOTONIC in nanoseconds (served by the vDSO, no system call).
+ */
+inline std::uint64_t latency_now() {
+#if defined(MP_LATENCY_TSC)
+    return __rdtsc();
+#else
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1'000'000'000u + static_cast<std::uint64_t>(ts.tv_nsec);
+#endif
+}
+
+#if defined(MP_LATENCY)
+
+/**
+ * latency_histogram of one shard of a latency_recorder. More threads than shards share them, so every counter is a
+ * relaxed atomic.
+ */
+class latency_shard {
+public:
+    void record(std::uint64_t value) {
+        counts_[latency_histogram::bucket_of(value)].fetch_add(1u, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+
+        auto max = max_.load(std::memory_order_relaxed);
+        while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        }
+        auto min = min_.load(std::memory_order_relaxed);
+        while (value < min && !min_.compare_exchange_weak(min, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    void add_to(latency_histogram& histogram) const {
+        // The total is summed from the buckets, one atomic less to update per sample
+        for (std::size_t i = 0u; i < latency_histogram::bucket_count; ++i) {
+            const auto count = counts_[i].load(std::memory_order_relaxed);
+            histogram.counts_[i] += count;
+            histogram.total_ += count;
+        }
+        histogram.sum_ += sum_.load(std::memory_order_relaxed);
+        histogram.max_ = std::max(histogram.max_, max_.load(std::memory_order_relaxed));
+        histogram.min_ = std::min(histogram.min_, min_.load(std::memory_order_relaxed));
+    }
+
+private:
+    std::array<std::atomic_uint64_t, latency_histogram::bucket_count> counts_{};
+    std::atomic_uint64_t sum_{0u};
+    std::atomic_uint64_t max_{0u};
+    std::atomic_uint64_t min_{~std::uint64_t{0u}};
+};
+
+/**
+ * One pair of histograms per thread shard (see stats_recorder), so the samples of a thread stay on its own cache
+ * lines. The 16 shards take about 250 KB per instrumented allocator.
+ */
+class latency_recorder {
+public:
+    enum class op_e { allocate, deallocate };
+
+    latency_recorder() : shards_{std::make_unique<shard_t[]>(stats_shards)} {}
+
+    class scope {
+    public:
+        scope(latency_recorder& recorder, op_e op) : recorder_{recorder}, op_{op}, start_{latency_now()} {}
+        ~scope() { recorder_.record(op_, latency_now() - start_); }
+
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+
+    private:
+        latency_recorder& recorder_;
+        op_e op_;
+        std::uint64_t start_;
+    };
+
+    [[nodiscard]] scope time(op_e op) { return scope{*this, op}; }
+
+    [[nodiscard]] latency_report_t snapshot() const {
+        latency_report_t report;
+        for (std::size_t i = 0u; i < stats_shards; ++i) {
+            shards_[i].allocate.add_to(report.allocate);
+            shards_[i].deallocate.add_to(report.deallocate);
+        }
+        return report;
+    }
+
+private:
+    struct alignas(cache_line_size) shard_t {
+        latency_shard allocate;
+        latency_shard deallocate;
+    };
+
+    void record(op_e op, std::uint64_t elapsed) {
+        auto& shard = shards_[this_thread_stats_shard()];
+        (op == op_e::allocate ? shard.allocate : shard.deallocate).record(elapsed);
+    }
+
+    std::unique_ptr<shard_t[]> shards_;
+};
+
+#else
+
+/**
+ * Latency instrumentation disabled: nothing is timed and the member takes no space.
+ */
+class latency_recorder {
+public:
+    enum class op_e { allocate, deallocate };
+
+    struct scope {};
+
+    [[nodiscard]] scope time(op_e) { return {}; }
+};
+
+#endif
+
+} // namespace detail
+
+} // namespace mp
@@ -0,0 +1,290 @@
+
+#pragma once
+
+#include "types.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace mp::detail {
+
+inline constexpr std::uint32_t no_index = std::numeric_limits<std::uint32_t>::max();
+
+/**
+ * Ring of slot indexes for one producer thread and one consumer thread. It never holds more than N indexes by
+ * construction (see message_queue), so push() has no full check.
+ */
+template <size_t N>
+class spsc_index_ring final {
+public:
+    void push(std::uint32_t idx) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        assert(tail - head_.load(std::memory_order_relaxed) < N);
+        indexes_[tail & (N - 1u)] = idx;
+        tail_.store(tail + 1u, std::memory_order_release);
+    }
+
+    // no_index when empty
+    [[nodiscard]] std::uint32_t pop() {
+        const size_t head = head_.load(std::memory_order_relaxed);
+
+        if (head == cached_tail_ && head == (cached_tail_ = tail_.load(std::memory_order_acquire))) {
+            return no_index;
+        }
+        const std::uint32_t idx = indexes_[head & (N - 1u)];
+        head_.store(head + 1u, std::memory_order_release);
+        return idx;
+    }
+
+private:
+    // Producer side and consumer side on their own cache lines
+    alignas(cache_line_size) std::atomic_size_t tail_{0u};
+    alignas(cache_line_size) std::atomic_size_t head_{0u};
+    size_t cached_tail_{0u};
+    alignas(cache_line_size) std::uint32_t indexes_[N] = {};
+};
+
+/**
+ * Bounded ring of slot indexes for any number of producers and consumers: every cell carries a sequence number
+ * telling whose turn it is, so a push or a pop is a compare-exchange on the position plus one store in the cell.
+ * Like spsc_index_ring it never holds more than N indexes; a push can still find its cell not yet left by a slower
+ * consumer of the previous lap, it then waits for it.
+ */
+template <size_t N>
+class mpmc_index_ring final {
+public:
+    mpmc_index_ring() {
+        for (size_t i = 0u; i < N; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    void push(std::uint32_t idx) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell_t& cell = cells_[pos & (N - 1u)];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+
+            if (sequence == pos) {
+                if (tail_.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed)) {
+                    cell.idx = idx;
+                    cell.sequence.store(pos + 1u, std::memory_order_release);
+                    return;
+                }
+            } else if (sequence < pos) {
+                std::this_thread::yield();
+                pos = tail_.load(std::memory_order_relaxed);
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // no_index when empty
+    [[nodiscard]] std::uint32_t pop() {
+        size_t pos = head_.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell_t& cell = cells_[pos & (N - 1u)];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+
+            if (sequence == pos + 1u) {
+                if (head_.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed)) {
+                    const std::uint32_t idx = cell.idx;
+                    cell.sequence.store(pos + N, std::memory_order_release);
+                    return idx;
+                }
+            } else if (sequence < pos + 1u) {
+                return no_index;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct cell_t {
+        std::atomic_size_t sequence{0u};
+        std::uint32_t idx{no_index};
+    };
+
+    alignas(cache_line_size) std::atomic_size_t tail_{0u};
+    alignas(cache_line_size) std::atomic_size_t head_{0u};
+    alignas(cache_line_size) cell_t cells_[N];
+};
+
+} // namespace mp::detail
+
+namespace mp {
+
+using error::code_e;
+using error::result_t;
+
+/**
+ * Threads on each side of a message_queue.
+ */
+enum class queue_e {
+    spsc, //!< one producer thread and one consumer thread
+    mpmc  //!< any number of both
+};
+
+/**
+ * Bounded queue passing messages between threads without copying them nor touching the heap. The queue owns
+ * NCapacity payload slots: a producer constructs its message in place in a free slot and publishes the 32-bit slot
+ * index through a lock-free ring, a consumer takes the index, works on the message where it is and releases the
+ * slot once done. The free slots travel back to the producers through a second ring of indexes, so the slots are
+ * recycled by the threads themselves and no allocator state is shared. Both rings are single-producer
+ * single-consumer or multi-producer multi-consumer depending on Mode.
+ */
+template <std::destructible T, size_t NCapacity, queue_e Mode = queue_e::spsc>
+    requires(std::has_single_bit(NCapacity) && NCapacity < detail::no_index)
+class message_queue final {
+public:
+    message_queue() = default;
+    message_queue(const message_queue&) = delete;
+    message_queue(message_queue&&) = delete;
+    message_queue& operator=(const message_queue&) = delete;
+    message_queue& operator=(message_queue&&) = delete;
+
+    ~message_queue() { deinitialize(); }
+
+    [[nodiscard]] constexpr bool is_initialized() const { return storage_ != nullptr; }
+
+    /**
+     * Reserves the payload slots, all free. No thread may use the queue before it returns.
+     */
+    auto initialize() -> std::expected<bool, result_t> {
+        if (is_initialized()) {
+            return result_t::unexp({code_e::already_initialized});
+        }
+        if (storage_ = static_cast<slot_t*>(std::aligned_alloc(alignof(slot_t), sizeof(slot_t) * NCapacity)); !storage_) {
+            return result_t::unexp({code_e::cannot_reserve_system_memory});
+        }
+        for (std::uint32_t idx = 0u; idx < NCapacity; ++idx) {
+            free_.push(idx);
+        }
+        return true;
+    }
+
+    /**
+     * Destroys the messages still queued and returns the memory to the system. No thread may use the queue anymore
+     * and the messages popped but not released are not destroyed.
+     */
+    void deinitialize() {
+        if (!is_initialized()) {
+            return;
+        }
+        for (std::uint32_t idx = ready_.pop(); idx != detail::no_index; idx = ready_.pop()) {
+            std::destroy_at(message_at(idx));
+        }
+        while (free_.pop() != detail::no_index) {
+        }
+        spare_ = detail::no_index;
+        std::free(storage_);
+        storage_ = nullptr;
+    }
+
+    /**
+     * Producer side: constructs a message in a free slot and publishes it.
+     * @return code_e::not_enough_space_in_allocator when the NCapacity slots are all taken (queued or still held
+     * by consumers)
+     */
+    template <typename... TArgs>
+    auto emplace(TArgs&&... args) noexcept -> std::expected<bool, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        const std::uint32_t idx = spare_ != detail::no_index ? std::exchange(spare_, detail::no_index) : free_.pop();
+
+        if (idx == detail::no_index) {
+            return result_t::unexp({code_e::not_enough_space_in_allocator});
+        }
+        try {
+            ::new (&storage_[idx]) T{std::forward<TArgs>(args)...};
+        } catch (...) {
+            // Only the consumer side may push to a single-producer free ring
+            if constexpr (Mode == queue_e::spsc) {
+                spare_ = idx;
+            } else {
+                free_.push(idx);
+            }
+            return result_t::unexp({code_e::exception_caught_in_ctor});
+        }
+        ready_.push(idx);
+        return true;
+    }
+
+    /**
+     * Consumer side: takes the oldest published message, it stays in its slot until release().
+     * @return nullptr when the queue is empty or not initialized
+     */
+    [[nodiscard]] T* try_pop() noexcept {
+        if (!is_initialized()) {
+            return nullptr;
+        }
+        const std::uint32_t idx = ready_.pop();
+        return idx == detail::no_index ? nullptr : message_at(idx);
+    }
+
+    /**
+     * Consumer side: destroys a message returned by try_pop() and hands its slot back to the producers.
+     */
+    void release(T* message) noexcept
+        requires std::is_nothrow_destructible_v<T>
+    {
+        const auto idx = static_cast<std::uint32_t>(reinterpret_cast<slot_t*>(message) - storage_);
+        assert(idx < NCapacity);
+        std::destroy_at(message);
+        free_.push(idx);
+    }
+
+    /**
+     * try_pop(), fn(T&) then release() in one call.
+     * @return false when the queue was empty
+     */
+    template <typename TFn>
+        requires std::invocable<TFn&, T&>
+    bool consume(TFn&& fn) {
+        T* message = try_pop();
+
+        if (!message) {
+            return false;
+        }
+        fn(*message);
+        release(message);
+        return true;
+    }
+
+    static constexpr size_t capacity() { return NCapacity; }
+
+private:
+    using ring_t = std::conditional_t<Mode == queue_e::spsc, detail::spsc_index_ring<NCapacity>,
+                                      detail::mpmc_index_ring<NCapacity>>;
+
+    struct alignas(T) slot_t {
+        std::byte bytes[sizeof(T)];
+    };
+
+    [[nodiscard]] T* message_at(std::uint32_t idx) const { return std::launder(reinterpret_cast<T*>(&storage_[idx])); }
+
+    ring_t ready_;
+    ring_t free_;
+    slot_t* storage_ = nullptr;
+    // Slot kept by the producer after a failed construction, spsc only
+    std::uint32_t spare_{detail::no_index};
+};
+
+} // namespace mp
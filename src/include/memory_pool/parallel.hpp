@@ -0,0 +1,111 @@
+
+#pragma once
+
+#include "allocator.hpp"
+#include "work_stealing.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <expected>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Parallel traversal of the live objects of an allocator or a pool. Kept out of allocator.hpp so only the users of
+ * these functions parse the parallel algorithms headers (and, with libstdc++, link TBB for the execution policies).
+ */
+namespace mp {
+
+/**
+ * allocator and pool: the live objects are visited chunk by chunk.
+ */
+template <typename TPool>
+concept ChunkVisitable = requires(TPool& pool, size_t chunk) {
+    { TPool::live_chunk_count } -> std::convertible_to<size_t>;
+    pool.for_each_live_in_chunk(chunk, [](auto&) {});
+};
+
+namespace detail {
+
+// A pool is initialized by construction, an allocator has to be checked
+template <ChunkVisitable TPool>
+[[nodiscard]] bool is_visitable(const TPool& pool) {
+    if constexpr (requires { pool.is_initialized(); }) {
+        return pool.is_initialized();
+    } else {
+        return true;
+    }
+}
+
+} // namespace detail
+
+/**
+ * Calls fn(T&) for every allocated object using the given number of threads, the calling one included. The bitmap
+ * is split in cache-line chunks shared between the threads with work stealing, so uneven occupancy keeps every
+ * thread busy. fn must be safe to call concurrently on distinct objects; the pool itself must not be modified while
+ * this runs.
+ * @return the number of visited objects
+ */
+template <ChunkVisitable TPool, typename TFn>
+auto parallel_for_each_live(TPool& pool, TFn&& fn, size_t threads = std::thread::hardware_concurrency())
+    -> std::expected<size_t, result_t> {
+    if (!detail::is_visitable(pool)) {
+        return result_t::unexp({code_e::not_initialized});
+    }
+    constexpr size_t chunks = TPool::live_chunk_count;
+    threads = std::clamp<size_t>(threads, 1u, chunks);
+
+    detail::work_stealing_ranges ranges{chunks, threads};
+    std::atomic_size_t visited{0u};
+
+    const auto worker = [&](size_t id) {
+        size_t local_visited{0u};
+        ranges.run(id, [&](size_t chunk) {
+            pool.for_each_live_in_chunk(chunk, [&](auto& obj) {
+                fn(obj);
+                ++local_visited;
+            });
+        });
+        visited.fetch_add(local_visited, std::memory_order_relaxed);
+    };
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(threads - 1u);
+        for (size_t id = 1u; id < threads; ++id) {
+            workers.emplace_back(worker, id);
+        }
+        worker(0u);
+    }
+    return visited.load(std::memory_order_relaxed);
+}
+
+/**
+ * Same as above but the chunks are handed to a standard parallel algorithm, scheduling is left to the library.
+ */
+template <typename TPolicy, ChunkVisitable TPool, typename TFn>
+    requires std::is_execution_policy_v<std::remove_cvref_t<TPolicy>>
+auto parallel_for_each_live(TPolicy&& policy, TPool& pool, TFn&& fn) -> std::expected<size_t, result_t> {
+    if (!detail::is_visitable(pool)) {
+        return result_t::unexp({code_e::not_initialized});
+    }
+    std::vector<size_t> chunks(TPool::live_chunk_count);
+    std::iota(chunks.begin(), chunks.end(), 0u);
+    std::atomic_size_t visited{0u};
+
+    std::for_each(std::forward<TPolicy>(policy), chunks.begin(), chunks.end(), [&](size_t chunk) {
+        size_t local_visited{0u};
+        pool.for_each_live_in_chunk(chunk, [&](auto& obj) {
+            fn(obj);
+            ++local_visited;
+        });
+        visited.fetch_add(local_visited, std::memory_order_relaxed);
+    });
+    return visited.load(std::memory_order_relaxed);
+}
+
+} // namespace mp
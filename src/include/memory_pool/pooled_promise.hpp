@@ -0,0 +1,135 @@
+
+#pragma once
+
+#include "remote_free_pool.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace mp {
+
+/**
+ * Mixin for coroutine promise types serving the coroutine frames from a pool instead of the global heap:
+ *
+ *     struct promise_type : mp::pooled_promise<256> { ... };
+ *
+ * Frames of up to NFrameSize bytes take a block of the calling thread's pool (NFrames blocks, created on the first
+ * coroutine of the thread); bigger frames, and every frame once the pool is full, go to the global heap. A frame may
+ * be destroyed on any thread, the block then goes back to its pool through the remote free stack of
+ * remote_free_pool. If a thread exits while frames it created are still alive, its pool is orphaned and deleted by
+ * whichever thread destroys the last of those frames; coroutines created on a thread after its pool is gone (from a
+ * thread_local destructor, ...) take their frame from the heap.
+ */
+template <size_t NFrameSize, size_t NFrames = 1024u>
+    requires(NFrameSize > 0u && NFrames > 0u)
+struct pooled_promise {
+    static void* operator new(std::size_t size) {
+        if (size <= NFrameSize) {
+            if (pool_state_t* state = this_thread_pool(); state) {
+                if (block_t* block = state->pool.try_allocate(state); block) {
+                    ++state->owner_live;
+                    return block->frame;
+                }
+            }
+        }
+        // Same layout as a block, the frame right after the header
+        auto* header = static_cast<header_t*>(::operator new(sizeof(header_t) + size));
+        header->pool = nullptr;
+        return header + 1;
+    }
+
+    static void operator delete(void* frame, std::size_t) noexcept {
+        auto* header = static_cast<header_t*>(frame) - 1;
+
+        if (auto* state = static_cast<pool_state_t*>(header->pool); state) {
+            state->pool.deallocate_unchecked(reinterpret_cast<block_t*>(header));
+            if (state == current_) {
+                --state->owner_live;
+            } else if (state->remote.fetch_sub(2, std::memory_order_acq_rel) == 3) {
+                // Last frame of an orphaned pool
+                delete state;
+            }
+        } else {
+            ::operator delete(header);
+        }
+    }
+
+    /**
+     * Frames of the calling thread's pool still allocated, including the ones destroyed by other threads and not
+     * taken back yet.
+     */
+    [[nodiscard]] static size_t pooled_frames() {
+        const pool_state_t* state = this_thread_pool();
+        return state ? state->pool.status().used : 0u;
+    }
+
+private:
+    struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) header_t {
+        void* pool; //!< owning pool_state_t, nullptr for the frames taken from the heap
+    };
+
+    struct block_t {
+        // The frame bytes are left uninitialized
+        explicit block_t(void* owner) noexcept : header{owner} {}
+
+        header_t header;
+        std::byte frame[NFrameSize];
+    };
+
+    using pool_t = remote_free_pool<block_t, NFrames>;
+
+    /**
+     * Pool of a thread and the count of its live frames. The owner counts its own allocations and frees in
+     * owner_live, the other threads subtract 2 from remote per frame they free. When the owner exits it adds
+     * 2 * owner_live + 1 to remote: the low bit marks the pool orphaned and the rest is twice the number of frames
+     * still alive, so exactly one thread sees the count reach zero and deletes the pool.
+     */
+    struct pool_state_t {
+        pool_t pool;
+        size_t owner_live{0u};
+        std::atomic<std::int64_t> remote{0};
+    };
+
+    /**
+     * Owns the pool of a thread, orphans it at thread exit.
+     */
+    struct pool_holder {
+        pool_holder() {
+            if (state && !state->pool.initialize()) {
+                delete state;
+                state = nullptr;
+            }
+        }
+        ~pool_holder() {
+            current_ = nullptr;
+            released_ = true;
+            if (state) {
+                const auto orphan = 2 * static_cast<std::int64_t>(state->owner_live) + 1;
+                if (state->remote.fetch_add(orphan, std::memory_order_acq_rel) + orphan == 1) {
+                    delete state;
+                }
+            }
+        }
+        pool_holder(const pool_holder&) = delete;
+        pool_holder& operator=(const pool_holder&) = delete;
+
+        pool_state_t* state = new (std::nothrow) pool_state_t{};
+    };
+
+    // The pointer is trivially initialized so the hot path does not go through the thread_local guard
+    static pool_state_t* this_thread_pool() {
+        if (!current_ && !released_) [[unlikely]] {
+            thread_local const pool_holder holder;
+            current_ = holder.state;
+        }
+        return current_;
+    }
+
+    // Pool of the calling thread, nullptr before its first coroutine and once the thread released it
+    static inline thread_local pool_state_t* current_ = nullptr;
+    static inline thread_local bool released_ = false;
+};
+
+} // namespace mp
@@ -0,0 +1,53 @@
+
+#pragma once
+
+/**
+ * USDT (user level statically defined tracing) probes, enabled with MP_USDT. Each probe is a single nop in the code
+ * plus an ELF note describing where its arguments live, so perf, bpftrace or SystemTap can attach to a running
+ * process. Every probe has a semaphore, a counter the tracer increments while attached: MP_PROBE() tests it and
+ * only evaluates the arguments when it is set, so an untraced probe costs a load and a predicted branch. Without
+ * MP_USDT the probes do not exist at all.
+ *
+ * Provider "mp", every probe gets the address of the allocator first:
+ *   mp:initialize       (allocator, capacity, sizeof(TAlloc))
+ *   mp:deinitialize     (allocator, used)
+ *   mp:allocate         (allocator, slot index, used)
+ *   mp:deallocate       (allocator, slot index, used)
+ *   mp:allocate_bucket  (allocator, first slot index, size, used)
+ *   mp:exhausted        (allocator, requested slots, used)
+ *
+ * e.g. bpftrace -e 'usdt:./app:mp:exhausted { @[ustack] = count(); }'
+ */
+#if defined(MP_USDT)
+    #if !__has_include(<sys/sdt.h>)
+        #error "MP_USDT needs <sys/sdt.h> (package systemtap-sdt-dev or systemtap-sdt-devel)"
+    #endif
+    // The probe notes then carry the address of the mp_<name>_semaphore variables below
+    #define _SDT_HAS_SEMAPHORES 1
+    #include <sys/sdt.h>
+
+    // Referenced by symbol name from the notes, hence the global namespace. Inline so every translation unit
+    // including this header shares one semaphore per probe.
+    #define MP_PROBE_SEMAPHORE(name) \
+        inline volatile unsigned short mp_##name##_semaphore __attribute__((unused, section(".probes"))) = 0u;
+
+MP_PROBE_SEMAPHORE(initialize)
+MP_PROBE_SEMAPHORE(deinitialize)
+MP_PROBE_SEMAPHORE(allocate)
+MP_PROBE_SEMAPHORE(deallocate)
+MP_PROBE_SEMAPHORE(allocate_bucket)
+MP_PROBE_SEMAPHORE(exhausted)
+
+    #undef MP_PROBE_SEMAPHORE
+
+    #define MP_PROBE_ENABLED(name) __builtin_expect(mp_##name##_semaphore != 0u, 0)
+    #define MP_PROBE(name, ...)                               \
+        do {                                                  \
+            if (MP_PROBE_ENABLED(name)) {                     \
+                STAP_PROBEV(mp, name, __VA_ARGS__);           \
+            }                                                 \
+        } while (false)
+#else
+    #define MP_PROBE_ENABLED(name) false
+    #define MP_PROBE(name, ...) static_cast<void>(0)
+#endif
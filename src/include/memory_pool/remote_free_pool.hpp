@@ -0,0 +1,251 @@
+
+#pragma once
+
+#include "slot_status_registry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace mp {
+
+using error::code_e;
+using error::result_t;
+
+/**
+ * Pool owned by one thread that any thread may free into. The owner allocates and frees through the registry as
+ * usual; another thread freeing an object destroys it and pushes its slot on the owner's remote free stack, a
+ * lock-free intrusive list threaded through the freed slots themselves, so it never touches the registry. The owner
+ * takes the whole stack with a single exchange on its next allocation and gives the slots back to the registry.
+ * Only allocate(), drain_remote_frees(), take_ownership() and deinitialize() are restricted to the owner.
+ */
+template <std::destructible TAlloc, size_t NAlloc>
+    requires(NAlloc > 0u)
+class remote_free_pool final {
+public:
+    remote_free_pool() = default;
+    remote_free_pool(const remote_free_pool&) = delete;
+    remote_free_pool(remote_free_pool&&) = delete;
+    remote_free_pool& operator=(const remote_free_pool&) = delete;
+    remote_free_pool& operator=(remote_free_pool&&) = delete;
+
+    ~remote_free_pool() { deinitialize(); }
+
+    [[nodiscard]] constexpr bool is_initialized() const { return initialized_.load(std::memory_order_acquire); }
+
+    /**
+     * Reserves the storage, the calling thread becomes the owner.
+     */
+    auto initialize() -> std::expected<bool, result_t> {
+        if (is_initialized()) {
+            return result_t::unexp({code_e::already_initialized});
+        }
+        if (storage_ = static_cast<slot_t*>(std::aligned_alloc(alignof(slot_t), sizeof(slot_t) * NAlloc)); !storage_) {
+            return result_t::unexp({code_e::cannot_reserve_system_memory});
+        }
+        owner_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        initialized_.store(true, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Destroys the live objects and returns the memory to the system. No other thread may free concurrently.
+     */
+    void deinitialize() {
+        if (is_initialized()) {
+            drain_remote_frees();
+            registry_.for_each_in_use([this](size_t idx) { std::destroy_at(object_at(idx)); });
+        }
+        initialized_.store(false, std::memory_order_release);
+        registry_.reset();
+        std::free(storage_);
+        storage_ = nullptr;
+    }
+
+    /**
+     * Hands the pool over to the calling thread, e.g. when the owning thread is replaced. The previous owner must
+     * be done with the pool and the hand-over synchronized by the caller (joining the previous owner, ...). The
+     * objects allocated before stay valid.
+     */
+    void take_ownership() {
+        owner_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        drain_remote_frees();
+    }
+
+    [[nodiscard]] bool is_owner() const {
+        return owner_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+    }
+
+    /**
+     * Constructs a new TAlloc, owner thread only. Slots freed by other threads since the last call are taken
+     * back first.
+     */
+    template <typename... TArgs>
+    [[nodiscard]] auto allocate(TArgs&&... args) noexcept -> std::expected<TAlloc*, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        assert(is_owner());
+
+        if (remote_head_.load(std::memory_order_relaxed) != nullptr) {
+            drain_remote_frees();
+        }
+        const size_t idx = registry_.try_fetch();
+
+        if (idx == NAlloc) {
+            return result_t::unexp({code_e::not_enough_space_in_allocator});
+        }
+        try {
+            return ::new (&storage_[idx]) TAlloc{std::forward<TArgs>(args)...};
+        } catch (...) {
+            registry_.release(idx);
+            return result_t::unexp({code_e::exception_caught_in_ctor});
+        }
+    }
+
+    /**
+     * Unchecked fast path of allocate(), see allocator::try_allocate(): owner thread only, the pool must be
+     * initialized (asserted in debug builds) and constructing TAlloc cannot throw.
+     * @return the new object, nullptr when there is no free slot
+     */
+    template <typename... TArgs>
+        requires requires { { TAlloc{std::declval<TArgs>()...} } noexcept; }
+    [[nodiscard]] TAlloc* try_allocate(TArgs&&... args) noexcept {
+        assert(is_initialized() && is_owner());
+
+        if (remote_head_.load(std::memory_order_relaxed) != nullptr) {
+            drain_remote_frees();
+        }
+        const size_t idx = registry_.try_fetch();
+
+        if (idx == NAlloc) [[unlikely]] {
+            return nullptr;
+        }
+        return ::new (&storage_[idx]) TAlloc{std::forward<TArgs>(args)...};
+    }
+
+    /**
+     * Destroys the object, from any thread. The owner releases the slot right away, any other thread queues it
+     * for the owner; a double free is only detected on the owner thread.
+     */
+    auto deallocate(TAlloc* allocated) noexcept -> std::expected<bool, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        const size_t idx = index_of(allocated);
+        const bool owner = is_owner();
+
+        if (idx == NAlloc || (owner && !registry_.in_use(idx))) {
+            return result_t::unexp({code_e::deallocation_has_failed,
+                                    error::describe("remote_free_pool::deallocate not allocated here idx={}", idx)});
+        }
+        try {
+            std::destroy_at(allocated);
+        } catch (...) {
+            return result_t::unexp({code_e::exception_caught_in_dctor});
+        }
+        if (owner) {
+            registry_.release_unchecked(idx);
+        } else {
+            push_remote(idx);
+        }
+        return true;
+    }
+
+    /**
+     * Unchecked fast path of deallocate(), from any thread: the pointer must come from this pool and still be
+     * allocated (asserted in debug builds).
+     */
+    void deallocate_unchecked(TAlloc* allocated) noexcept
+        requires std::is_nothrow_destructible_v<TAlloc>
+    {
+        assert(is_initialized() && owns(allocated));
+        const size_t idx = index_of(allocated);
+        std::destroy_at(allocated);
+
+        if (is_owner()) {
+            registry_.release_unchecked(idx);
+        } else {
+            push_remote(idx);
+        }
+    }
+
+    /**
+     * Gives the slots freed by other threads back to the registry, owner thread only. allocate() already does it
+     * whenever some are pending.
+     * @return the number of slots given back
+     */
+    size_t drain_remote_frees() {
+        node_t* node = remote_head_.exchange(nullptr, std::memory_order_acquire);
+        size_t drained{0u};
+
+        while (node) {
+            node_t* next = node->next;
+            registry_.release_unchecked(index_of(node));
+            node = next;
+            ++drained;
+        }
+        return drained;
+    }
+
+    /**
+     * True when the pointer points to a slot of this pool.
+     */
+    [[nodiscard]] bool owns(const TAlloc* ptr) const { return index_of(ptr) < NAlloc; }
+
+    /**
+     * Occupancy seen by the owner, the slots freed remotely and not drained yet still count as used.
+     */
+    [[nodiscard]] auto status() const { return registry_.status(); }
+
+private:
+    // Link of the remote free stack, written over the destroyed object
+    struct node_t {
+        node_t* next;
+    };
+
+    struct alignas(std::max(alignof(TAlloc), alignof(node_t))) slot_t {
+        std::byte bytes[std::max(sizeof(TAlloc), sizeof(node_t))];
+    };
+
+    void push_remote(size_t idx) {
+        node_t* node = ::new (&storage_[idx]) node_t{remote_head_.load(std::memory_order_relaxed)};
+        while (!remote_head_.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                                   std::memory_order_relaxed)) {
+        }
+    }
+
+    [[nodiscard]] TAlloc* object_at(size_t idx) const { return std::launder(reinterpret_cast<TAlloc*>(&storage_[idx])); }
+
+    // Slot of an address inside the storage, NAlloc for any other address
+    [[nodiscard]] size_t index_of(const void* ptr) const {
+        const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        const auto first = reinterpret_cast<std::uintptr_t>(storage_);
+
+        if (address < first || address >= first + sizeof(slot_t) * NAlloc || (address - first) % sizeof(slot_t) != 0u) {
+            return NAlloc;
+        }
+        return (address - first) / sizeof(slot_t);
+    }
+
+    // Owner side
+    slot_status_registry<NAlloc> registry_;
+    slot_t* storage_ = nullptr;
+    std::atomic_bool initialized_ = false;
+    std::atomic<std::thread::id> owner_{};
+
+    // Shared with the freeing threads, on its own cache line
+    alignas(cache_line_size) std::atomic<node_t*> remote_head_{nullptr};
+};
+
+} // namespace mp
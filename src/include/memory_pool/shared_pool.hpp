@@ -0,0 +1,377 @@
+
+#pragma once
+
+#include "slot_status_registry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <tuple>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+    #include <climits>
+    #include <ctime>
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace mp {
+
+using error::code_e;
+using error::result_t;
+
+namespace detail {
+
+/**
+ * Sleep of the atomic_wait_for() fallback without futex, growing from 1 us to 1 ms over the calls of one wait. Each
+ * new wait starts with a fresh one.
+ */
+struct wait_backoff_t {
+    std::chrono::microseconds delay{1};
+};
+
+/**
+ * std::atomic<T>::wait() with a timeout, which C++20 does not have: blocks while `word` holds `old`, at most for
+ * `timeout`. On Linux this is the futex wait libstdc++ issues for std::atomic::wait(); elsewhere it sleeps with the
+ * exponential backoff of the caller's wait. Spurious returns are possible, callers check their condition again.
+ */
+inline void atomic_wait_for(const std::atomic_uint& word, unsigned int old, std::chrono::nanoseconds timeout,
+                            [[maybe_unused]] wait_backoff_t& backoff) {
+    static_assert(sizeof(std::atomic_uint) == sizeof(std::uint32_t), "futex words are 32 bits");
+    if (word.load(std::memory_order_acquire) != old || timeout <= std::chrono::nanoseconds::zero()) {
+        return;
+    }
+#if defined(__linux__)
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    const timespec relative{.tv_sec = static_cast<std::time_t>(seconds.count()),
+                            .tv_nsec = static_cast<long>((timeout - seconds).count())};
+    ::syscall(SYS_futex, &word, FUTEX_WAIT_PRIVATE, old, &relative, nullptr, 0);
+#else
+    std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(backoff.delay, timeout));
+    backoff.delay = std::min(backoff.delay * 2, std::chrono::microseconds{1000});
+#endif
+}
+
+/**
+ * std::atomic<T>::notify_one() counterpart of atomic_wait_for().
+ */
+inline void atomic_notify_one([[maybe_unused]] const std::atomic_uint& word) {
+#if defined(__linux__)
+    ::syscall(SYS_futex, &word, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+}
+
+/**
+ * std::atomic<T>::notify_all() counterpart of atomic_wait_for().
+ */
+inline void atomic_notify_all([[maybe_unused]] const std::atomic_uint& word) {
+#if defined(__linux__)
+    ::syscall(SYS_futex, &word, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+} // namespace detail
+
+/**
+ * Thread-safe pool applying backpressure: when every slot is taken, coroutines can co_await async_allocate() and
+ * are resumed in FIFO order as slots are freed, and threads can block in allocate_wait(), instead of failing or
+ * spinning. A freed slot is handed directly to
+ * the oldest waiter, so a later allocate() never overtakes a coroutine already waiting.
+ * The registry and the waiter queue are protected by a mutex, the objects are constructed outside of it.
+ */
+template <std::destructible TAlloc, size_t NAlloc>
+    requires(NAlloc > 0u)
+class shared_pool final {
+public:
+    shared_pool() = default;
+    shared_pool(const shared_pool&) = delete;
+    shared_pool(shared_pool&&) = delete;
+    shared_pool& operator=(const shared_pool&) = delete;
+    shared_pool& operator=(shared_pool&&) = delete;
+
+    ~shared_pool() { deinitialize(); }
+
+    [[nodiscard]] constexpr bool is_initialized() const { return initialized_.load(std::memory_order_acquire); }
+
+    auto initialize() -> std::expected<bool, result_t> {
+        std::lock_guard lock{mutex_};
+
+        if (is_initialized()) {
+            return result_t::unexp({code_e::already_initialized});
+        }
+        if (storage_ = static_cast<TAlloc*>(std::aligned_alloc(alignof(TAlloc), storage_size_)); !storage_) {
+            return result_t::unexp({code_e::cannot_reserve_system_memory});
+        }
+        initialized_.store(true, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Destroys the live objects and returns the memory to the system. Coroutines still waiting are resumed and
+     * threads sleeping in allocate_wait() are woken, their allocation fails with code_e::not_initialized.
+     */
+    void deinitialize() {
+        std::unique_lock lock{mutex_};
+
+        if (is_initialized()) {
+            registry_.for_each_in_use([this](size_t idx) { std::destroy_at(&storage_[idx]); });
+        }
+        initialized_.store(false, std::memory_order_release);
+        registry_.reset();
+        std::free(storage_);
+        storage_ = nullptr;
+
+        awaiter* waiters = std::exchange(first_waiter_, nullptr);
+        last_waiter_ = nullptr;
+        waiting_ = 0u;
+        lock.unlock();
+
+        // reset() changed the counter the sleepers wait on, see recycle() for the fence
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) != 0u) {
+            detail::atomic_notify_all(registry_.occupancy());
+        }
+        while (waiters) {
+            awaiter* next = waiters->next_;
+            waiters->slot_ = NAlloc;
+            waiters->handle_.resume();
+            waiters = next;
+        }
+    }
+
+    /**
+     * Constructs a new TAlloc if a slot is free, never waits.
+     */
+    template <typename... TArgs>
+    [[nodiscard]] auto allocate(TArgs&&... args) noexcept -> std::expected<TAlloc*, result_t> {
+        size_t idx{NAlloc};
+        {
+            std::lock_guard lock{mutex_};
+            if (!is_initialized()) {
+                return result_t::unexp({code_e::not_initialized});
+            }
+            idx = registry_.try_fetch();
+        }
+        if (idx == NAlloc) {
+            return result_t::unexp({code_e::not_enough_space_in_allocator});
+        }
+        return construct(idx, std::forward<TArgs>(args)...);
+    }
+
+    /**
+     * Blocking allocation for threads: waits until a slot is free, at most for the given timeout, then constructs
+     * the object. The thread sleeps on the occupancy counter of the registry and every freed slot wakes a single
+     * sleeper, so releasing one slot does not wake every waiting thread. Coroutines waiting in async_allocate() are
+     * served first, and no ordering is guaranteed between sleeping threads.
+     * @return the new object, code_e::timed_out if no slot was freed in time
+     */
+    template <typename TRep, typename TPeriod, typename... TArgs>
+    [[nodiscard]] auto allocate_wait(std::chrono::duration<TRep, TPeriod> timeout, TArgs&&... args) noexcept
+        -> std::expected<TAlloc*, result_t> {
+        using clock = std::chrono::steady_clock;
+        const auto start = clock::now();
+        const auto deadline = timeout >= clock::time_point::max() - start
+                                  ? clock::time_point::max()
+                                  : start + std::chrono::ceil<clock::duration>(timeout);
+        detail::wait_backoff_t backoff;
+
+        for (;;) {
+            size_t idx{NAlloc};
+            {
+                std::lock_guard lock{mutex_};
+                if (!is_initialized()) {
+                    return result_t::unexp({code_e::not_initialized});
+                }
+                idx = registry_.try_fetch();
+            }
+            if (idx != NAlloc) {
+                return construct(idx, std::forward<TArgs>(args)...);
+            }
+            const auto now = clock::now();
+            if (now >= deadline) {
+                return result_t::unexp({code_e::timed_out});
+            }
+            // The counter is read again inside the wait, a slot freed since the fetch makes it return at once
+            sleepers_.fetch_add(1u, std::memory_order_seq_cst);
+            detail::atomic_wait_for(registry_.occupancy(), static_cast<unsigned int>(NAlloc), deadline - now, backoff);
+            sleepers_.fetch_sub(1u, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Awaitable allocation: `auto obj = co_await pool.async_allocate(args...);` gives a std::expected<TAlloc*,
+     * result_t> as allocate() does, but suspends the coroutine while the pool is full. The arguments are copied
+     * (or moved) into the awaiter since the construction may happen after a suspension. The coroutine is resumed
+     * by the deallocate() that frees its slot, on the deallocating thread; it must not be destroyed while waiting.
+     */
+    template <typename... TArgs>
+    [[nodiscard]] auto async_allocate(TArgs&&... args) {
+        return allocation_awaiter<std::decay_t<TArgs>...>{*this, std::forward<TArgs>(args)...};
+    }
+
+    /**
+     * Destroys the object. The slot goes to the oldest waiting coroutine if there is one, which is resumed before
+     * this call returns.
+     */
+    auto deallocate(TAlloc* allocated) noexcept -> std::expected<bool, result_t> {
+        std::unique_lock lock{mutex_};
+
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        const size_t idx = index_of(allocated);
+        if (idx == NAlloc || !registry_.in_use(idx)) {
+            return result_t::unexp({code_e::deallocation_has_failed,
+                                    error::describe("shared_pool::deallocate not allocated here idx={}", idx)});
+        }
+        try {
+            std::destroy_at(allocated);
+        } catch (...) {
+            return result_t::unexp({code_e::exception_caught_in_dctor});
+        }
+        recycle(idx, lock);
+        return true;
+    }
+
+    /**
+     * Number of coroutines waiting for a slot.
+     */
+    [[nodiscard]] size_t waiting() const {
+        std::lock_guard lock{mutex_};
+        return waiting_;
+    }
+
+    [[nodiscard]] auto status() const { return registry_.status(); }
+
+private:
+    /**
+     * Intrusive node of the waiter queue, see async_allocate().
+     */
+    class awaiter {
+    protected:
+        friend class shared_pool;
+
+        explicit awaiter(shared_pool& pool) : pool_{pool} {}
+
+        // Fetches a slot or queues the coroutine, under the pool mutex; false when the coroutine was queued
+        bool fetch_or_enqueue(std::coroutine_handle<> handle) {
+            std::lock_guard lock{pool_.mutex_};
+
+            if (!pool_.is_initialized()) {
+                slot_ = NAlloc;
+                return true;
+            }
+            if (slot_ = pool_.registry_.try_fetch(); slot_ != NAlloc) {
+                return true;
+            }
+            handle_ = handle;
+            if (pool_.last_waiter_) {
+                pool_.last_waiter_->next_ = this;
+            } else {
+                pool_.first_waiter_ = this;
+            }
+            pool_.last_waiter_ = this;
+            ++pool_.waiting_;
+            return false;
+        }
+
+        shared_pool& pool_;
+        std::coroutine_handle<> handle_{};
+        awaiter* next_ = nullptr;
+        size_t slot_ = NAlloc;
+    };
+
+    template <typename... TArgs>
+    class allocation_awaiter final : public awaiter {
+    public:
+        template <typename... TFwd>
+        explicit allocation_awaiter(shared_pool& pool, TFwd&&... args)
+            : awaiter{pool}, args_{std::forward<TFwd>(args)...} {}
+
+        bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> handle) { return !this->fetch_or_enqueue(handle); }
+
+        auto await_resume() -> std::expected<TAlloc*, result_t> {
+            if (this->slot_ == NAlloc) {
+                return result_t::unexp({code_e::not_initialized});
+            }
+            return std::apply(
+                [this](TArgs&... args) { return this->pool_.construct(this->slot_, std::move(args)...); }, args_);
+        }
+
+    private:
+        std::tuple<TArgs...> args_;
+    };
+
+    template <typename... TArgs>
+    auto construct(size_t idx, TArgs&&... args) noexcept -> std::expected<TAlloc*, result_t> {
+        try {
+            return ::new (&storage_[idx]) TAlloc{std::forward<TArgs>(args)...};
+        } catch (...) {
+            std::unique_lock lock{mutex_};
+            recycle(idx, lock);
+            return result_t::unexp({code_e::exception_caught_in_ctor});
+        }
+    }
+
+    // Gives a fetched slot to the oldest waiter, or back to the registry; unlocks the mutex
+    void recycle(size_t idx, std::unique_lock<std::mutex>& lock) {
+        if (awaiter* waiter = first_waiter_; waiter) {
+            first_waiter_ = waiter->next_;
+            if (!first_waiter_) {
+                last_waiter_ = nullptr;
+            }
+            --waiting_;
+            waiter->slot_ = idx;
+            lock.unlock();
+            waiter->handle_.resume();
+        } else {
+            registry_.release_unchecked(idx);
+            lock.unlock();
+
+            // Orders the release before reading sleepers_, paired with the increment in allocate_wait()
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleepers_.load(std::memory_order_relaxed) != 0u) {
+                detail::atomic_notify_one(registry_.occupancy());
+            }
+        }
+    }
+
+    // Slot of a pointer handed out by this pool, NAlloc for any other pointer
+    [[nodiscard]] size_t index_of(const TAlloc* ptr) const {
+        const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        const auto first = reinterpret_cast<std::uintptr_t>(storage_);
+
+        if (address < first || address >= first + NAlloc * sizeof(TAlloc) || (address - first) % sizeof(TAlloc) != 0u) {
+            return NAlloc;
+        }
+        return (address - first) / sizeof(TAlloc);
+    }
+
+    static constexpr auto storage_size_ =
+        ((NAlloc * sizeof(TAlloc) + alignof(TAlloc) - 1u) / alignof(TAlloc)) * alignof(TAlloc);
+
+    mutable std::mutex mutex_;
+    slot_status_registry<NAlloc> registry_;
+    std::atomic_bool initialized_ = false;
+    TAlloc* storage_ = nullptr;
+    awaiter* first_waiter_ = nullptr;
+    awaiter* last_waiter_ = nullptr;
+    size_t waiting_{0u};
+    std::atomic_uint32_t sleepers_{0u};
+};
+
+} // namespace mp
@@ -0,0 +1,248 @@
+
+#pragma once
+
+#include "slot_status_registry.hpp"
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <utility>
+
+namespace mp {
+
+using error::code_e;
+using error::result_t;
+
+/**
+ * Stable reference to an object of a slot_map. The generation detects use after the object was deallocated, even if
+ * the handle index was reused since.
+ */
+struct handle_t {
+    std::uint32_t index{std::numeric_limits<std::uint32_t>::max()};
+    std::uint32_t generation{0u};
+
+    friend bool operator==(const handle_t&, const handle_t&) = default;
+};
+
+/**
+ * Pool handing out generational handles instead of raw pointers. Handles go through an indirection table, so the
+ * objects themselves can be moved: compact() packs the live objects into a dense prefix of the storage.
+ */
+template <std::move_constructible TAlloc, size_t NAlloc>
+    requires(NAlloc > 0u && NAlloc < std::numeric_limits<std::uint32_t>::max())
+class slot_map final {
+public:
+    slot_map() = default;
+    slot_map(const slot_map&) = delete;
+    slot_map(slot_map&&) = delete;
+    slot_map& operator=(const slot_map&) = delete;
+    slot_map& operator=(slot_map&&) = delete;
+
+    ~slot_map() { deinitialize(); }
+
+    [[nodiscard]] constexpr bool is_initialized() const { return initialized_.load(std::memory_order_acquire); }
+
+    /**
+     * Reserves the object storage and the indirection table.
+     */
+    auto initialize() -> std::expected<bool, result_t> {
+        if (is_initialized()) {
+            return result_t::unexp({code_e::already_initialized});
+        }
+        try {
+            entries_ = std::make_unique_for_overwrite<entry_t[]>(NAlloc);
+            owners_ = std::make_unique_for_overwrite<std::uint32_t[]>(NAlloc);
+        } catch (const std::bad_alloc&) {
+            deinitialize();
+            return result_t::unexp({code_e::cannot_reserve_system_memory});
+        }
+        if (storage_ = static_cast<TAlloc*>(std::aligned_alloc(alignof(TAlloc), storage_size_)); !storage_) {
+            deinitialize();
+            return result_t::unexp({code_e::cannot_reserve_system_memory});
+        }
+        // Every entry starts in the free list, in index order
+        for (std::uint32_t i = 0u; i < NAlloc; ++i) {
+            entries_[i] = entry_t{.position = i + 1u, .generation = 0u};
+        }
+        free_entry_ = 0u;
+        initialized_.store(true, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Destroys the live objects and returns the memory to the system. Every outstanding handle becomes invalid.
+     */
+    void deinitialize() {
+        if (is_initialized()) {
+            registry_.for_each_in_use([this](size_t position) { std::destroy_at(&storage_[position]); });
+        }
+        initialized_.store(false, std::memory_order_release);
+        registry_.reset();
+        std::free(storage_);
+        storage_ = nullptr;
+        entries_.reset();
+        owners_.reset();
+    }
+
+    /**
+     * Constructs a new TAlloc and returns the handle to reach it.
+     */
+    template <typename... TArgs>
+    [[nodiscard]] auto allocate(TArgs&&... args) noexcept -> std::expected<handle_t, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        const size_t fetched = registry_.try_fetch();
+
+        if (fetched == NAlloc) {
+            return result_t::unexp({code_e::not_enough_space_in_allocator});
+        }
+        const auto position = static_cast<std::uint32_t>(fetched);
+        try {
+            ::new (&storage_[position]) TAlloc{std::forward<TArgs>(args)...};
+        } catch (...) {
+            registry_.release(position);
+            return result_t::unexp({code_e::exception_caught_in_ctor});
+        }
+        // The registry and the free list hold the same number of free slots
+        const std::uint32_t index = free_entry_;
+        entry_t& entry = entries_[index];
+        free_entry_ = entry.position;
+        entry.position = position;
+        owners_[position] = index;
+
+        return handle_t{.index = index, .generation = entry.generation};
+    }
+
+    /**
+     * Destroys the object and invalidates every copy of its handle.
+     */
+    auto deallocate(handle_t handle) noexcept -> std::expected<bool, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        if (!contains(handle)) {
+            return result_t::unexp({code_e::invalid_handle, error::describe("slot_map::deallocate index={} generation={}",
+                                                                            handle.index, handle.generation)});
+        }
+        entry_t& entry = entries_[handle.index];
+        const std::uint32_t position = entry.position;
+        try {
+            std::destroy_at(&storage_[position]);
+        } catch (...) {
+            return result_t::unexp({code_e::exception_caught_in_dctor});
+        }
+        registry_.release(position);
+        ++entry.generation;
+        entry.position = free_entry_;
+        free_entry_ = handle.index;
+
+        return true;
+    }
+
+    /**
+     * Tells whether the handle still refers to a live object.
+     */
+    [[nodiscard]] bool contains(handle_t handle) const {
+        if (!is_initialized() || handle.index >= NAlloc) {
+            return false;
+        }
+        const entry_t& entry = entries_[handle.index];
+        return entry.generation == handle.generation && registry_.in_use(entry.position) &&
+               owners_[entry.position] == handle.index;
+    }
+
+    /**
+     * Validated O(1) lookup, nullptr for stale or foreign handles. The pointer is invalidated by compact().
+     */
+    [[nodiscard]] TAlloc* get(handle_t handle) {
+        return contains(handle) ? &storage_[entries_[handle.index].position] : nullptr;
+    }
+
+    /**
+     * Moves the live objects into the first positions of the storage, filling the holes left by deallocations
+     * with objects taken from the end. Handles stay valid, raw pointers obtained before do not.
+     * @return a span over all the live objects, contiguous
+     */
+    auto compact() -> std::expected<std::span<TAlloc>, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        const size_t used = registry_.status().used;
+        size_t hole = registry_.next_free(0u);
+        size_t last = NAlloc;
+
+        while (hole < used) {
+            while (!registry_.in_use(--last)) {
+            }
+            try {
+                ::new (&storage_[hole]) TAlloc{std::move(storage_[last])};
+            } catch (...) {
+                return result_t::unexp({code_e::exception_caught_in_ctor});
+            }
+            std::destroy_at(&storage_[last]);
+
+            const std::uint32_t index = owners_[last];
+            entries_[index].position = static_cast<std::uint32_t>(hole);
+            owners_[hole] = index;
+            std::ignore = registry_.claim(hole);
+            registry_.release(last);
+
+            hole = registry_.next_free(hole + 1u);
+        }
+        return std::span<TAlloc>{storage_, used};
+    }
+
+    /**
+     * Calls fn(TAlloc&) for every live object in storage order.
+     */
+    template <typename TFn>
+        requires std::invocable<TFn&, TAlloc&>
+    auto for_each_live(TFn&& fn) -> std::expected<size_t, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        size_t visited{0u};
+        registry_.for_each_in_use([&](size_t position) {
+            fn(storage_[position]);
+            ++visited;
+        });
+        return visited;
+    }
+
+    /**
+     * True when the live objects occupy exactly the first positions of the storage.
+     */
+    [[nodiscard]] bool is_compacted() const { return registry_.next_free(0u) >= registry_.status().used; }
+
+    [[nodiscard]] auto status() const { return registry_.status(); }
+
+private:
+    /**
+     * Indirection table entry. A live entry holds the storage position of its object, a free one the index of
+     * the next free entry.
+     */
+    struct entry_t {
+        std::uint32_t position;
+        std::uint32_t generation;
+    };
+
+    static constexpr auto storage_size_ =
+        ((NAlloc * sizeof(TAlloc) + alignof(TAlloc) - 1u) / alignof(TAlloc)) * alignof(TAlloc);
+
+    slot_status_registry<NAlloc> registry_;
+    std::atomic_bool initialized_ = false;
+    std::uint32_t free_entry_ = 0u;
+    TAlloc* storage_ = nullptr;
+    std::unique_ptr<entry_t[]> entries_;
+    std::unique_ptr<std::uint32_t[]> owners_;
+};
+
+} // namespace mp
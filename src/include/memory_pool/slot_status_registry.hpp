@@ -5,9 +5,12 @@
 
 #include <algorithm>
 #include <atomic>
+#include <bit>
+#include <cassert>
 #include <climits>
 #include <cstddef>
 #include <expected>
+#include <iterator>
 #include <vector>
 
 namespace mp {
@@ -36,22 +39,22 @@ public:
         if (!has_free_space(qty)) {
             return result_t::unexp({code_e::not_enough_space_in_allocator});
         }
-        unsigned int* it = data_;
-        static unsigned int* end = data_ + max_index_;
         std::vector<size_t> free_indexes;
-        size_t idx{0u};
+        free_indexes.reserve(qty);
 
-        while (it < end) {
-            if (!is_in_use(idx)) {
+        // Words before first_free_word_ are known to be full, the free bits of the others are found with countr_zero
+        for (size_t word = first_free_word_; word < data_size_ && free_indexes.size() < qty; ++word) {
+            unsigned int free_bits = ~data_[word] & valid_bits(word);
+
+            while (free_bits != 0u && free_indexes.size() < qty) {
+                const size_t idx = word * bits_per_int_ + static_cast<size_t>(std::countr_zero(free_bits));
+                free_bits &= free_bits - 1u;
                 set(idx);
                 free_indexes.push_back(idx);
-
-                if (free_indexes.size() == qty) {
-                    break;
-                }
             }
-            ++idx;
-            ++it;
+        }
+        while (first_free_word_ < data_size_ && data_[first_free_word_] == valid_bits(first_free_word_)) {
+            ++first_free_word_;
         }
         if (free_indexes.size() != qty) {
             return result_t::unexp({code_e::bad_logic});
@@ -59,25 +62,138 @@ public:
         return free_indexes;
     }
 
+    /**
+     * Fetches the first free slot without building a vector, for the allocation fast paths.
+     * @return the fetched index, N when there is no free slot
+     */
+    [[nodiscard]] size_t try_fetch() noexcept {
+        for (size_t word = first_free_word_; word < data_size_; ++word) {
+            if (const unsigned int free_bits = ~data_[word] & valid_bits(word); free_bits != 0u) {
+                const size_t idx = word * bits_per_int_ + static_cast<size_t>(std::countr_zero(free_bits));
+                set(idx);
+                first_free_word_ = word;
+                return idx;
+            }
+        }
+        first_free_word_ = data_size_;
+        return N;
+    }
+
+    /**
+     * Word where the search for a free slot starts, every word before it is full.
+     */
+    [[nodiscard]] size_t first_free_word() const { return first_free_word_; }
+
+    static constexpr size_t slots_per_word = sizeof(unsigned int) * CHAR_BIT;
+
     /**
      * Released a pre-fetched slot using its index. If the slot was not in use then does nothing.
      */
     void release(size_t idx) {
         if (idx < N && is_in_use(idx)) {
             unset(idx);
+            first_free_word_ = std::min(first_free_word_, idx / bits_per_int_);
         }
     }
 
+    /**
+     * Releases a slot known to be in use, the caller is responsible for the index being valid.
+     */
+    void release_unchecked(size_t idx) noexcept {
+        assert(idx < N && is_in_use(idx));
+        unset(idx);
+        first_free_word_ = std::min(first_free_word_, idx / bits_per_int_);
+    }
+
     /**
      * Releases all the slots
      */
     void reset() {
-        unsigned int* it = data_;
-        static const unsigned int* end = data_ + N;
+        std::fill(std::begin(data_), std::end(data_), 0u);
+        first_free_word_ = 0u;
+        in_use_.store(0u, std::memory_order_release);
+    }
+
+    /**
+     * Tells whether the slot at the given index is currently fetched. Out of range indexes are never in use.
+     */
+    [[nodiscard]] bool in_use(size_t idx) const { return idx < N && is_in_use(idx); }
+
+    /**
+     * Returns the index of the first slot in use at or after `from`, or N when there is none.
+     * Scans whole words, skipping 32 free slots at a time.
+     */
+    [[nodiscard]] size_t next_in_use(size_t from) const {
+        if (from >= N) {
+            return N;
+        }
+        size_t word = from / bits_per_int_;
+        unsigned int bits = data_[word] & (~0u << (from % bits_per_int_));
+
+        while (bits == 0u) {
+            if (++word == data_size_) {
+                return N;
+            }
+            bits = data_[word];
+        }
+        return word * bits_per_int_ + static_cast<size_t>(std::countr_zero(bits));
+    }
+
+    /**
+     * Returns the index of the first free slot at or after `from`, or N when there is none.
+     */
+    [[nodiscard]] size_t next_free(size_t from) const {
+        if (from >= N) {
+            return N;
+        }
+        size_t word = from / bits_per_int_;
+        unsigned int bits = ~data_[word] & valid_bits(word) & (~0u << (from % bits_per_int_));
+
+        while (bits == 0u) {
+            if (++word == data_size_) {
+                return N;
+            }
+            bits = ~data_[word] & valid_bits(word);
+        }
+        return word * bits_per_int_ + static_cast<size_t>(std::countr_zero(bits));
+    }
 
-        while (it < end) {
-            *it++ = 0u;
+    /**
+     * Fetches one specific slot.
+     * @return false when the slot is out of range or already in use
+     */
+    [[nodiscard]] bool claim(size_t idx) {
+        if (idx >= N || is_in_use(idx)) {
+            return false;
+        }
+        set(idx);
+        while (first_free_word_ < data_size_ && data_[first_free_word_] == valid_bits(first_free_word_)) {
+            ++first_free_word_;
         }
+        return true;
+    }
+
+    /**
+     * Calls fn(idx) for every slot in use, in ascending index order.
+     */
+    template <typename TFn>
+    void for_each_in_use(TFn&& fn) const {
+        for_each_in_use_words(0u, data_size_, fn);
+    }
+
+    /**
+     * The bitmap is split in chunks of one cache line each so that concurrent readers never share a line.
+     */
+    static constexpr size_t slots_per_chunk = cache_line_size * CHAR_BIT;
+    static constexpr size_t chunk_count = (N + slots_per_chunk - 1u) / slots_per_chunk;
+
+    /**
+     * Calls fn(idx) for every slot in use within the given chunk, in ascending index order.
+     */
+    template <typename TFn>
+    void for_each_in_use_in_chunk(size_t chunk, TFn&& fn) const {
+        const size_t first = chunk * words_per_chunk_;
+        for_each_in_use_words(std::min(first, data_size_), std::min(first + words_per_chunk_, data_size_), fn);
     }
 
     struct status_t {
@@ -94,18 +210,38 @@ public:
         return status_t{.used = used, .free = N - used};
     }
 
+    /**
+     * The counter behind status().used, for the callers that wait on it (see shared_pool::allocate_wait()).
+     */
+    [[nodiscard]] const std::atomic_uint& occupancy() const { return in_use_; }
+
 private:
     [[nodiscard]] bool has_free_space(size_t total_needed) const {
         return total_needed <= (N - in_use_.load(std::memory_order_acquire));
     }
 
+    // Bits of the last word beyond N do not map to any slot
+    static constexpr unsigned int valid_bits(size_t word) {
+        constexpr size_t tail = N % bits_per_int_;
+        return (tail != 0u && word == data_size_ - 1u) ? ((1u << tail) - 1u) : ~0u;
+    }
+
+    template <typename TFn>
+    void for_each_in_use_words(size_t first_word, size_t last_word, TFn& fn) const {
+        for (size_t word = first_word; word < last_word; ++word) {
+            for (unsigned int bits = data_[word]; bits != 0u; bits &= bits - 1u) {
+                fn(word * bits_per_int_ + static_cast<size_t>(std::countr_zero(bits)));
+            }
+        }
+    }
+
     void set(size_t idx) {
         if constexpr (power_of_two_) {
             data_[idx / bits_per_int_] |= (1u << (idx & (bits_per_int_ - 1u)));
         } else {
             data_[idx / bits_per_int_] |= (1u << (idx % bits_per_int_));
         }
-        in_use_.fetch_add(1u, std::memory_order_release);
+        in_use_.store(in_use_.load(std::memory_order_relaxed) + 1u, std::memory_order_release);
     }
 
     void unset(size_t idx) {
@@ -114,7 +250,7 @@ private:
         } else {
             data_[idx / bits_per_int_] &= ~(1u << (idx % bits_per_int_));
         }
-        in_use_.fetch_sub(1u, std::memory_order_release);
+        in_use_.store(in_use_.load(std::memory_order_relaxed) - 1u, std::memory_order_release);
     }
 
     // Only used internally no need to do a bound check
@@ -134,10 +270,15 @@ private:
     // If NUM_SLOTS is power of two, so is IntBits.
     static constexpr bool power_of_two_ = (N & (N - 1u)) == 0u;
 
-    static constexpr size_t max_index_ = std::min(data_size_, N);
+    static constexpr size_t words_per_chunk_ = cache_line_size / sizeof(unsigned int);
+
+    alignas(cache_line_size) unsigned int data_[data_size_] = {0u};
 
-    unsigned int data_[data_size_] = {0u};
+    size_t first_free_word_ = 0u;
 
+    // Only written by one thread at a time (the owner, or under the caller's lock as in shared_pool), atomic so
+    // status() and the futex waiters can read it from any thread; a plain store is enough, a read-modify-write
+    // would cost a locked instruction on every fetch and release
     std::atomic_uint in_use_ = 0u;
 };
 
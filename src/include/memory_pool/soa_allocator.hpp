@@ -0,0 +1,355 @@
+
+#pragma once
+
+#include "slot_status_registry.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <expected>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mp {
+
+using error::code_e;
+using error::result_t;
+
+namespace detail {
+
+/**
+ * Placeholder convertible to any field type. Only used in unevaluated contexts to count the members of an aggregate.
+ */
+struct any_field_t {
+    template <typename T>
+    constexpr operator T() const noexcept;
+};
+
+template <typename T, typename... TFields>
+consteval size_t aggregate_field_count() {
+    if constexpr (requires { T{TFields{}..., any_field_t{}}; }) {
+        return aggregate_field_count<T, TFields..., any_field_t>();
+    } else {
+        return sizeof...(TFields);
+    }
+}
+
+/**
+ * Binds the members of an aggregate to a tuple of references. Structured bindings are the only portable
+ * "reflection" available, hence one branch per supported arity.
+ */
+template <typename T>
+constexpr auto tie_fields(T& value) noexcept {
+    constexpr auto count = aggregate_field_count<std::remove_cv_t<T>>();
+    static_assert(count > 0u && count <= 8u, "soa_allocator supports aggregates with 1 up to 8 fields");
+
+    if constexpr (count == 1u) {
+        auto& [a] = value;
+        return std::tie(a);
+    } else if constexpr (count == 2u) {
+        auto& [a, b] = value;
+        return std::tie(a, b);
+    } else if constexpr (count == 3u) {
+        auto& [a, b, c] = value;
+        return std::tie(a, b, c);
+    } else if constexpr (count == 4u) {
+        auto& [a, b, c, d] = value;
+        return std::tie(a, b, c, d);
+    } else if constexpr (count == 5u) {
+        auto& [a, b, c, d, e] = value;
+        return std::tie(a, b, c, d, e);
+    } else if constexpr (count == 6u) {
+        auto& [a, b, c, d, e, f] = value;
+        return std::tie(a, b, c, d, e, f);
+    } else if constexpr (count == 7u) {
+        auto& [a, b, c, d, e, f, g] = value;
+        return std::tie(a, b, c, d, e, f, g);
+    } else {
+        auto& [a, b, c, d, e, f, g, h] = value;
+        return std::tie(a, b, c, d, e, f, g, h);
+    }
+}
+
+template <typename TTuple> struct remove_tuple_refs;
+
+template <typename... TFields> struct remove_tuple_refs<std::tuple<TFields...>> {
+    using type = std::tuple<std::remove_cvref_t<TFields>...>;
+};
+
+template <typename T> struct is_tuple : std::false_type {};
+template <typename... TFields> struct is_tuple<std::tuple<TFields...>> : std::true_type {};
+
+} // namespace detail
+
+/**
+ * Maps a type to the list of fields stored by soa_allocator. A std::tuple is taken as the field list itself,
+ * aggregates are decomposed member by member.
+ */
+template <typename T> struct soa_traits {
+    using fields_t = typename detail::remove_tuple_refs<decltype(detail::tie_fields(std::declval<T&>()))>::type;
+
+    static constexpr auto tie(T& value) noexcept { return detail::tie_fields(value); }
+};
+
+template <typename... TFields> struct soa_traits<std::tuple<TFields...>> {
+    using fields_t = std::tuple<TFields...>;
+
+    static constexpr auto tie(std::tuple<TFields...>& value) noexcept {
+        return std::apply([](auto&... fields) { return std::tie(fields...); }, value);
+    }
+};
+
+template <typename T>
+concept SoaDecomposable = std::is_default_constructible_v<T> && (detail::is_tuple<T>::value || std::is_aggregate_v<T>);
+
+/**
+ * Structure-of-arrays flavour of the allocator: every field of TAlloc lives in its own contiguous array indexed
+ * by slot, so loops touching only a few fields do not drag the others through the cache.
+ * Each field array is default constructed at initialize() so the per-field spans are always safe to iterate; free
+ * slots simply hold default values.
+ */
+template <SoaDecomposable TAlloc, size_t NAlloc>
+    requires(NAlloc > 0u)
+class soa_allocator final {
+public:
+    using fields_t = typename soa_traits<TAlloc>::fields_t;
+
+    template <size_t I> using field_t = std::tuple_element_t<I, fields_t>;
+
+    static constexpr size_t field_count = std::tuple_size_v<fields_t>;
+
+    /**
+     * Proxy standing for one object spread over the field arrays.
+     */
+    class reference {
+    public:
+        reference(const reference&) = default;
+
+        template <size_t I>
+        [[nodiscard]] field_t<I>& get() const {
+            return std::get<I>(owner_->storage_)[idx_];
+        }
+
+        [[nodiscard]] size_t index() const { return idx_; }
+
+        /**
+         * Gathers the fields back into a TAlloc value.
+         */
+        [[nodiscard]] TAlloc load() const {
+            return [this]<size_t... Is>(std::index_sequence<Is...>) { return TAlloc{get<Is>()...}; }(indexes_t{});
+        }
+
+        /**
+         * Scatters a TAlloc value into the field arrays.
+         */
+        const reference& operator=(const TAlloc& value) const {
+            TAlloc copy = value;
+            [this, fields = soa_traits<TAlloc>::tie(copy)]<size_t... Is>(std::index_sequence<Is...>) {
+                ((get<Is>() = std::move(std::get<Is>(fields))), ...);
+            }(indexes_t{});
+            return *this;
+        }
+
+        /**
+         * Copies the fields of the other object, like any proxy reference; the proxy itself is not rebound.
+         */
+        const reference& operator=(const reference& other) const {
+            [this, &other]<size_t... Is>(std::index_sequence<Is...>) {
+                ((get<Is>() = other.template get<Is>()), ...);
+            }(indexes_t{});
+            return *this;
+        }
+
+        friend bool operator==(const reference& a, const reference& b) {
+            return a.owner_ == b.owner_ && a.idx_ == b.idx_;
+        }
+
+    private:
+        friend class soa_allocator<TAlloc, NAlloc>;
+
+        reference(soa_allocator* owner, size_t idx) : owner_{owner}, idx_{idx} {}
+
+        soa_allocator* owner_ = nullptr;
+        size_t idx_ = 0u;
+    };
+
+    soa_allocator() = default;
+    soa_allocator(const soa_allocator&) = delete;
+    soa_allocator(soa_allocator&&) = delete;
+    soa_allocator& operator=(const soa_allocator&) = delete;
+    soa_allocator& operator=(soa_allocator&&) = delete;
+
+    ~soa_allocator() { deinitialize(); }
+
+    [[nodiscard]] constexpr bool is_initialized() const { return initialized_.load(std::memory_order_acquire); }
+
+    /**
+     * Reserves one array per field and default constructs its elements.
+     */
+    auto initialize() -> std::expected<bool, result_t> {
+        if (is_initialized()) {
+            return result_t::unexp({code_e::already_initialized});
+        }
+        const bool reserved = [this]<size_t... Is>(std::index_sequence<Is...>) {
+            return (reserve_field<Is>() && ...);
+        }(indexes_t{});
+
+        if (!reserved) {
+            release_fields();
+            return result_t::unexp({code_e::cannot_reserve_system_memory});
+        }
+        initialized_.store(true, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Return the used memory to the system.
+     */
+    void deinitialize() {
+        release_fields();
+        initialized_.store(false, std::memory_order_release);
+        registry_.reset();
+    }
+
+    /**
+     * Allocates a slot and assigns its fields. Accepts either no argument (default values), one value per field
+     * or a whole TAlloc.
+     */
+    template <typename... TArgs>
+        requires(sizeof...(TArgs) == 0u || sizeof...(TArgs) == field_count)
+    [[nodiscard]] auto allocate(TArgs&&... args) noexcept -> std::expected<reference, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        const size_t idx = registry_.try_fetch();
+
+        if (idx == NAlloc) {
+            return result_t::unexp({code_e::not_enough_space_in_allocator});
+        }
+        const reference ref{this, idx};
+
+        if constexpr (sizeof...(TArgs) > 0u) {
+            try {
+                [&]<size_t... Is>(std::index_sequence<Is...>) {
+                    ((ref.template get<Is>() = std::forward<TArgs>(args)), ...);
+                }(indexes_t{});
+            } catch (...) {
+                reset_slot(ref.index());
+                return result_t::unexp({code_e::exception_caught_in_ctor});
+            }
+        }
+        return ref;
+    }
+
+    [[nodiscard]] auto allocate(const TAlloc& value) noexcept -> std::expected<reference, result_t>
+        requires(field_count > 1u)
+    {
+        auto ref = allocate();
+
+        if (ref) {
+            try {
+                *ref = value;
+            } catch (...) {
+                reset_slot(ref->index());
+                return result_t::unexp({code_e::exception_caught_in_ctor});
+            }
+        }
+        return ref;
+    }
+
+    /**
+     * Gives the fields of the slot back their default values and releases it.
+     */
+    auto deallocate(const reference& allocated) noexcept -> std::expected<bool, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        if (allocated.owner_ != this || !registry_.in_use(allocated.index())) {
+            return result_t::unexp({code_e::deallocation_has_failed,
+                                    error::describe("soa_allocator::deallocate idx={}", allocated.index())});
+        }
+        try {
+            reset_slot(allocated.index());
+        } catch (...) {
+            return result_t::unexp({code_e::exception_caught_in_dctor});
+        }
+        return true;
+    }
+
+    /**
+     * Unchecked access to the slot at the given index, allocated or not.
+     */
+    [[nodiscard]] reference operator[](size_t idx) { return reference{this, idx}; }
+
+    /**
+     * The whole array of a field, one element per slot, meant for vectorized loops. Free slots hold default values,
+     * use is_live() to skip them when it matters.
+     */
+    template <size_t I>
+        requires(I < field_count)
+    [[nodiscard]] auto field() -> std::expected<std::span<field_t<I>, NAlloc>, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        return std::span<field_t<I>, NAlloc>{std::get<I>(storage_), NAlloc};
+    }
+
+    [[nodiscard]] bool is_live(size_t idx) const { return registry_.in_use(idx); }
+
+    [[nodiscard]] auto status() const { return registry_.status(); }
+
+private:
+    using indexes_t = std::make_index_sequence<field_count>;
+
+    template <typename TFields> struct pointers;
+
+    template <typename... TFields> struct pointers<std::tuple<TFields...>> {
+        using type = std::tuple<TFields*...>;
+    };
+
+    template <size_t I>
+    bool reserve_field() {
+        using field = field_t<I>;
+        // aligned_alloc requires the size to be a multiple of the alignment
+        constexpr size_t size = ((NAlloc * sizeof(field) + alignof(field) - 1u) / alignof(field)) * alignof(field);
+
+        auto* data = static_cast<field*>(std::aligned_alloc(alignof(field), size));
+        if (!data) {
+            return false;
+        }
+        try {
+            std::uninitialized_value_construct(data, data + NAlloc);
+        } catch (...) {
+            std::free(data);
+            return false;
+        }
+        std::get<I>(storage_) = data;
+        return true;
+    }
+
+    // Every reserved field array is fully constructed, see reserve_field()
+    void release_fields() {
+        std::apply(
+            [](auto*&... data) {
+                ((data ? (std::destroy(data, data + NAlloc), std::free(data)) : void()), ...);
+                ((data = nullptr), ...);
+            },
+            storage_);
+    }
+
+    void reset_slot(size_t idx) {
+        [this, idx]<size_t... Is>(std::index_sequence<Is...>) {
+            ((std::get<Is>(storage_)[idx] = field_t<Is>{}), ...);
+        }(indexes_t{});
+        registry_.release(idx);
+    }
+
+    slot_status_registry<NAlloc> registry_;
+    std::atomic_bool initialized_ = false;
+    typename pointers<fields_t>::type storage_{};
+};
+
+} // namespace mp
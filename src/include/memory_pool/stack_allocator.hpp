@@ -0,0 +1,173 @@
+
+#pragma once
+
+#include "bump_region.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <expected>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace mp {
+
+using error::code_e;
+using error::result_t;
+
+/**
+ * LIFO allocator for temporaries whose lifetimes nest, e.g. the scratch objects of a recursive-descent parser.
+ * NBytes are reserved by initialize() like mp::allocator does; allocations move the top of the stack forward and
+ * are released by rewinding it to a marker taken before, either explicitly with mark() / rewind() or with the
+ * guard returned by scoped(). No metadata is stored per object, so only trivially destructible objects can be
+ * made, and the memory released last is the one handed out next, still hot in cache. Not thread safe.
+ */
+template <size_t NBytes>
+    requires(NBytes > 0u)
+class stack_allocator final {
+public:
+    /**
+     * Position of the top of the stack, see mark().
+     */
+    class marker_t {
+    public:
+        friend bool operator==(const marker_t&, const marker_t&) = default;
+
+    private:
+        friend class stack_allocator<NBytes>;
+
+        explicit marker_t(size_t offset) : offset_{offset} {}
+
+        size_t offset_{0u};
+    };
+
+    /**
+     * Rewinds the stack to where it was at its construction when it goes out of scope, see scoped(). When rewind()
+     * went below that point during the scope, what was allocated since belongs to an outer scope and the stack is
+     * left where it is.
+     */
+    class scope_guard final {
+    public:
+        scope_guard(const scope_guard&) = delete;
+        scope_guard(scope_guard&&) = delete;
+        scope_guard& operator=(const scope_guard&) = delete;
+        scope_guard& operator=(scope_guard&&) = delete;
+
+        ~scope_guard() {
+            if (owner_.low_water_ >= offset_) {
+                owner_.region_.rewind(std::min(owner_.region_.top(), offset_));
+            }
+            owner_.low_water_ = std::min(outer_low_water_, owner_.low_water_);
+        }
+
+    private:
+        friend class stack_allocator<NBytes>;
+
+        explicit scope_guard(stack_allocator& owner)
+            : owner_{owner}, offset_{owner.region_.top()}, outer_low_water_{std::exchange(owner.low_water_, offset_)} {}
+
+        stack_allocator& owner_;
+        size_t offset_;
+        size_t outer_low_water_;
+    };
+
+    struct status_t {
+        size_t used; //!< bytes, alignment padding included
+        size_t free;
+    };
+
+    stack_allocator() = default;
+    stack_allocator(const stack_allocator&) = delete;
+    stack_allocator(stack_allocator&&) = delete;
+    stack_allocator& operator=(const stack_allocator&) = delete;
+    stack_allocator& operator=(stack_allocator&&) = delete;
+
+    ~stack_allocator() { deinitialize(); }
+
+    [[nodiscard]] constexpr bool is_initialized() const { return region_.is_reserved(); }
+
+    /**
+     * Reserves the NBytes of the stack, aligned on a cache line.
+     */
+    auto initialize() -> std::expected<bool, result_t> { return region_.reserve(); }
+
+    /**
+     * Returns the memory to the system, every pointer and marker handed out before is invalidated.
+     */
+    void deinitialize() {
+        region_.release();
+        low_water_ = std::numeric_limits<size_t>::max();
+    }
+
+    /**
+     * Raw uninitialized bytes on top of the stack, align must be a power of two.
+     */
+    [[nodiscard]] auto allocate(size_t bytes, size_t align = alignof(std::max_align_t)) noexcept
+        -> std::expected<void*, result_t> {
+        return region_.allocate(bytes, align, "stack_allocator");
+    }
+
+    /**
+     * Constructs a T on top of the stack. It is never destroyed, its memory is simply reused after a rewind.
+     */
+    template <typename T, typename... TArgs>
+        requires std::is_trivially_destructible_v<T>
+    [[nodiscard]] auto make(TArgs&&... args) noexcept -> std::expected<T*, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        const size_t offset = region_.top();
+        void* ptr = region_.bump(sizeof(T), alignof(T));
+
+        if (!ptr) {
+            return result_t::unexp({code_e::not_enough_space_in_allocator});
+        }
+        try {
+            return ::new (ptr) T{std::forward<TArgs>(args)...};
+        } catch (...) {
+            region_.rewind(offset);
+            return result_t::unexp({code_e::exception_caught_in_ctor});
+        }
+    }
+
+    /**
+     * Current top of the stack, everything allocated after it is released by rewind().
+     */
+    [[nodiscard]] marker_t mark() const { return marker_t{region_.top()}; }
+
+    /**
+     * Releases everything allocated since the marker was taken. Markers taken after it become invalid, rewinding to
+     * one of them once the stack is below it is reported as bad_logic.
+     */
+    auto rewind(marker_t marker) noexcept -> std::expected<bool, result_t> {
+        if (marker.offset_ > region_.top()) {
+            return result_t::unexp({code_e::bad_logic, error::describe("stack_allocator::rewind marker={} top={}",
+                                                                       marker.offset_, region_.top())});
+        }
+        region_.rewind(marker.offset_);
+        low_water_ = std::min(low_water_, marker.offset_);
+        return true;
+    }
+
+    /**
+     * Guard releasing everything allocated during its lifetime:
+     *
+     *     const auto scope = stack.scoped();
+     */
+    [[nodiscard]] scope_guard scoped() { return scope_guard{*this}; }
+
+    /**
+     * True when the pointer points inside the used part of the stack.
+     */
+    [[nodiscard]] bool owns(const void* ptr) const { return region_.owns(ptr); }
+
+    [[nodiscard]] status_t status() const { return status_t{.used = region_.top(), .free = NBytes - region_.top()}; }
+
+private:
+    detail::bump_region<NBytes> region_;
+    // Lowest offset rewind() went to since the innermost live scope_guard was made
+    size_t low_water_{std::numeric_limits<size_t>::max()};
+};
+
+} // namespace mp
@@ -0,0 +1,213 @@
+
+#pragma once
+
+#include "types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <string>
+#include <string_view>
+
+#if defined(MP_STATS)
+    #include <unistd.h>
+#endif
+
+namespace mp {
+
+using error::code_e;
+
+inline constexpr std::size_t code_count = static_cast<std::size_t>(code_e::timed_out) + 1u;
+
+/**
+ * Name of an error code, as printed in the statistics dumps.
+ */
+constexpr std::string_view to_string(code_e code) {
+    constexpr std::array<std::string_view, code_count> names = {
+        "ok",
+        "bad_logic",
+        "not_initialized",
+        "already_initialized",
+        "cannot_reserve_system_memory",
+        "not_enough_space_in_allocator",
+        "exception_caught_in_ctor",
+        "exception_caught_in_dctor",
+        "out_of_bounds",
+        "deallocation_has_failed",
+        "invalid_handle",
+        "timed_out",
+    };
+    const auto idx = static_cast<std::size_t>(code);
+    return idx < names.size() ? names[idx] : "unknown";
+}
+
+/**
+ * Aggregated allocation statistics of one allocator, see allocator::stats_snapshot().
+ */
+struct stats_t {
+    enum class format_e { text, json };
+
+    std::uint64_t allocations{0u};
+    std::uint64_t deallocations{0u};
+    std::uint64_t bucket_allocations{0u};
+    std::uint64_t high_water_mark{0u};
+    std::uint64_t fetches{0u};
+    std::uint64_t fetch_scanned_words{0u};
+    std::array<std::uint64_t, code_count> failures{};
+
+    /**
+     * Mean number of bitmap words looked at to find a free slot, 1 is the best case.
+     */
+    [[nodiscard]] double mean_fetch_scan_length() const {
+        return fetches == 0u ? 0.0 : static_cast<double>(fetch_scanned_words) / static_cast<double>(fetches);
+    }
+
+    [[nodiscard]] std::string to_string(format_e format = format_e::text) const {
+        std::string out;
+
+        if (format == format_e::json) {
+            out = std::format("{{\"allocations\":{},\"deallocations\":{},\"bucket_allocations\":{},"
+                              "\"high_water_mark\":{},\"mean_fetch_scan_length\":{:.3f},\"failures\":{{",
+                              allocations, deallocations, bucket_allocations, high_water_mark, mean_fetch_scan_length());
+            bool first = true;
+            for (std::size_t code = 1u; code < code_count; ++code) {
+                if (failures[code] != 0u) {
+                    out += std::format("{}\"{}\":{}", first ? "" : ",", mp::to_string(code_e(code)), failures[code]);
+                    first = false;
+                }
+            }
+            out += "}}\n";
+        } else {
+            out = std::format("allocations: {}\ndeallocations: {}\nbucket_allocations: {}\nhigh_water_mark: {}\n"
+                              "mean_fetch_scan_length: {:.3f}\n",
+                              allocations, deallocations, bucket_allocations, high_water_mark, mean_fetch_scan_length());
+            for (std::size_t code = 1u; code < code_count; ++code) {
+                if (failures[code] != 0u) {
+                    out += std::format("failures.{}: {}\n", mp::to_string(code_e(code)), failures[code]);
+                }
+            }
+        }
+        return out;
+    }
+
+#if defined(MP_STATS)
+    /**
+     * Writes the dump to a file descriptor (a file, a pipe, STDERR_FILENO...).
+     * @return false if the descriptor did not accept the whole dump
+     */
+    bool write(int fd, format_e format = format_e::text) const {
+        const std::string out = to_string(format);
+        std::size_t written{0u};
+
+        while (written < out.size()) {
+            const auto n = ::write(fd, out.data() + written, out.size() - written);
+            if (n <= 0) {
+                return false;
+            }
+            written += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+#endif
+};
+
+namespace detail {
+
+inline constexpr std::size_t stats_shards = 16u;
+
+/**
+ * Shard used by the calling thread, threads are spread round-robin in order of first use.
+ */
+inline std::size_t this_thread_stats_shard() {
+    static std::atomic_size_t next{0u};
+    thread_local const std::size_t shard = next.fetch_add(1u, std::memory_order_relaxed) % stats_shards;
+    return shard;
+}
+
+#if defined(MP_STATS)
+
+/**
+ * Counters of an allocator. They are sharded by thread, each shard on its own cache lines, so threads counting
+ * concurrently do not contend; snapshot() sums the shards.
+ */
+class stats_recorder {
+public:
+    // The occupancy is read here, so the call sites evaluate nothing when the statistics are disabled
+    template <typename TRegistry>
+    void allocated(std::size_t count, const TRegistry& registry) {
+        local().allocations.fetch_add(count, std::memory_order_relaxed);
+        const std::size_t used = registry.status().used;
+        auto hwm = high_water_mark_.load(std::memory_order_relaxed);
+        while (used > hwm && !high_water_mark_.compare_exchange_weak(hwm, used, std::memory_order_relaxed)) {
+        }
+    }
+
+    void bucket_allocated() { local().bucket_allocations.fetch_add(1u, std::memory_order_relaxed); }
+
+    void deallocated() { local().deallocations.fetch_add(1u, std::memory_order_relaxed); }
+
+    void fetched(std::size_t scanned_words) {
+        auto& shard = local();
+        shard.fetches.fetch_add(1u, std::memory_order_relaxed);
+        shard.fetch_scanned_words.fetch_add(scanned_words, std::memory_order_relaxed);
+    }
+
+    void failed(code_e code) {
+        local().failures[std::min(static_cast<std::size_t>(code), code_count - 1u)].fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] stats_t snapshot() const {
+        stats_t stats;
+        stats.high_water_mark = high_water_mark_.load(std::memory_order_relaxed);
+
+        for (const auto& shard : shards_) {
+            stats.allocations += shard.allocations.load(std::memory_order_relaxed);
+            stats.deallocations += shard.deallocations.load(std::memory_order_relaxed);
+            stats.bucket_allocations += shard.bucket_allocations.load(std::memory_order_relaxed);
+            stats.fetches += shard.fetches.load(std::memory_order_relaxed);
+            stats.fetch_scanned_words += shard.fetch_scanned_words.load(std::memory_order_relaxed);
+            for (std::size_t code = 0u; code < code_count; ++code) {
+                stats.failures[code] += shard.failures[code].load(std::memory_order_relaxed);
+            }
+        }
+        return stats;
+    }
+
+private:
+    struct alignas(cache_line_size) shard_t {
+        std::atomic_uint64_t allocations{0u};
+        std::atomic_uint64_t deallocations{0u};
+        std::atomic_uint64_t bucket_allocations{0u};
+        std::atomic_uint64_t fetches{0u};
+        std::atomic_uint64_t fetch_scanned_words{0u};
+        std::array<std::atomic_uint64_t, code_count> failures{};
+    };
+
+    shard_t& local() { return shards_[this_thread_stats_shard()]; }
+
+    std::array<shard_t, stats_shards> shards_{};
+    alignas(cache_line_size) std::atomic_uint64_t high_water_mark_{0u};
+};
+
+#else
+
+/**
+ * Statistics disabled: every call is an empty inline function and the member takes no space.
+ */
+class stats_recorder {
+public:
+    void allocated(std::size_t, const auto&) {}
+    void bucket_allocated() {}
+    void deallocated() {}
+    void fetched(std::size_t) {}
+    void failed(code_e) {}
+};
+
+#endif
+
+} // namespace detail
+
+} // namespace mp
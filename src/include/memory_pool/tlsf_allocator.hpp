@@ -0,0 +1,311 @@
+
+#pragma once
+
+#include "types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+
+namespace mp {
+
+using error::code_e;
+using error::result_t;
+
+/**
+ * Two-Level Segregated Fit allocator: variable-sized blocks out of one region of NBytes reserved by initialize(),
+ * with allocate() and deallocate() in O(1) whatever the size and the state of the region, for the paths where the
+ * worst case matters more than the average.
+ * The free blocks are kept in segregated lists: the first level splits the sizes in powers of two, the second level
+ * splits every power of two in 32 linear ranges. One bitmap tells which first-level classes have free blocks and
+ * one bitmap per class tells which of its lists are not empty, so the smallest list that is guaranteed to fit a
+ * request is found with two bit scans and no search. A block bigger than needed is split, a freed block is merged
+ * on the spot with its free physical neighbours. Blocks are 16-byte aligned with a 16-byte header. Not thread safe.
+ */
+template <size_t NBytes>
+    requires(NBytes >= 1024u)
+class tlsf_allocator final {
+    static constexpr size_t align_ = 16u;
+    static constexpr size_t sl_log2_ = 5u;
+    static constexpr size_t sl_count_ = 1u << sl_log2_;
+    // Sizes below small_size_ all live in the first class, in lists align_ bytes apart
+    static constexpr size_t fl_shift_ = sl_log2_ + std::countr_zero(align_);
+    static constexpr size_t small_size_ = size_t{1u} << fl_shift_;
+
+    struct block_t {
+        block_t* prev_physical; //!< only valid when the previous block is free
+        size_t size;            //!< payload bytes, flags in the low bits
+        // The payload starts here, a free block stores its list links in it
+        block_t* next_free;
+        block_t* prev_free;
+    };
+    static constexpr size_t header_size_ = offsetof(block_t, next_free);
+    static constexpr size_t min_payload_ = sizeof(block_t) - header_size_;
+    static constexpr size_t free_flag_ = 1u;
+    static constexpr size_t prev_free_flag_ = 2u;
+    static constexpr size_t flags_ = free_flag_ | prev_free_flag_;
+
+    static constexpr size_t floor_log2(size_t value) {
+        return sizeof(size_t) * CHAR_BIT - 1u - static_cast<size_t>(std::countl_zero(value));
+    }
+
+public:
+    /**
+     * Largest block allocate() can return.
+     */
+    static constexpr size_t max_allocation = (NBytes - 2u * header_size_) & ~(align_ - 1u);
+
+    struct status_t {
+        size_t used; //!< bytes not available for allocation, block headers included
+        size_t free; //!< payload bytes of the free blocks
+    };
+
+    tlsf_allocator() = default;
+    tlsf_allocator(const tlsf_allocator&) = delete;
+    tlsf_allocator(tlsf_allocator&&) = delete;
+    tlsf_allocator& operator=(const tlsf_allocator&) = delete;
+    tlsf_allocator& operator=(tlsf_allocator&&) = delete;
+
+    ~tlsf_allocator() { deinitialize(); }
+
+    [[nodiscard]] constexpr bool is_initialized() const { return storage_ != nullptr; }
+
+    /**
+     * Reserves the region, a single free block covering it and an empty sentinel block closing it.
+     */
+    auto initialize() -> std::expected<bool, result_t> {
+        if (is_initialized()) {
+            return result_t::unexp({code_e::already_initialized});
+        }
+        if (storage_ = static_cast<std::byte*>(std::aligned_alloc(cache_line_size, required_size_)); !storage_) {
+            return result_t::unexp({code_e::cannot_reserve_system_memory});
+        }
+        auto* block = reinterpret_cast<block_t*>(storage_);
+        block->prev_physical = nullptr;
+        block->size = max_allocation | free_flag_;
+
+        block_t* sentinel = next_physical(block);
+        sentinel->prev_physical = block;
+        sentinel->size = prev_free_flag_;
+
+        insert_free(block);
+        return true;
+    }
+
+    /**
+     * Returns the region to the system, every block handed out before is invalidated.
+     */
+    void deinitialize() {
+        std::free(storage_);
+        storage_ = nullptr;
+        fl_bitmap_ = 0u;
+        sl_bitmaps_.fill(0u);
+        for (auto& lists : free_lists_) {
+            lists.fill(nullptr);
+        }
+        free_ = 0u;
+    }
+
+    /**
+     * Uninitialized block of at least `bytes`, 16-byte aligned.
+     */
+    [[nodiscard]] auto allocate(size_t bytes) noexcept -> std::expected<void*, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        if (bytes > max_allocation) {
+            return result_t::unexp({code_e::out_of_bounds, error::describe("tlsf_allocator::allocate bytes={}", bytes)});
+        }
+        const size_t size = std::max((bytes + align_ - 1u) & ~(align_ - 1u), min_payload_);
+        block_t* block = find_free(size);
+
+        if (!block) {
+            return result_t::unexp({code_e::not_enough_space_in_allocator});
+        }
+        remove_free(block);
+
+        // Split off the tail when it can hold a block of its own
+        if (const size_t available = size_of(block); available >= size + sizeof(block_t)) {
+            block->size = size | (block->size & prev_free_flag_);
+            auto* rest = next_physical(block);
+            rest->size = (available - size - header_size_) | free_flag_;
+            link_next(rest);
+            insert_free(rest);
+        } else {
+            block->size &= ~free_flag_;
+            next_physical(block)->size &= ~prev_free_flag_;
+        }
+        return payload_of(block);
+    }
+
+    /**
+     * Gives a block back, merged right away with the free blocks around it.
+     */
+    auto deallocate(void* ptr) noexcept -> std::expected<bool, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        block_t* block = block_of(ptr);
+
+        if (!block) {
+            return result_t::unexp({code_e::deallocation_has_failed,
+                                    error::describe("tlsf_allocator::deallocate not allocated here ptr={}", ptr)});
+        }
+        block->size |= free_flag_;
+
+        if (block_t* next = next_physical(block); next->size & free_flag_) {
+            remove_free(next);
+            block->size += header_size_ + size_of(next);
+        }
+        if (block->size & prev_free_flag_) {
+            block_t* prev = block->prev_physical;
+            remove_free(prev);
+            prev->size += header_size_ + size_of(block);
+            block = prev;
+        }
+        link_next(block);
+        insert_free(block);
+        return true;
+    }
+
+    /**
+     * Usable size of an allocated block, 0 for any other pointer.
+     */
+    [[nodiscard]] size_t block_size(const void* ptr) const {
+        const block_t* block = block_of(ptr);
+        return block ? size_of(block) : 0u;
+    }
+
+    [[nodiscard]] constexpr status_t status() const { return status_t{.used = NBytes - free_, .free = free_}; }
+
+private:
+    static constexpr size_t fl_count_ = floor_log2(max_allocation) - fl_shift_ + 2u;
+    static_assert(fl_count_ <= sizeof(std::uint32_t) * CHAR_BIT);
+
+    // std::aligned_alloc() wants a multiple of the alignment
+    static constexpr size_t required_size_ = (NBytes + cache_line_size - 1u) / cache_line_size * cache_line_size;
+
+    struct index_t {
+        size_t fl;
+        size_t sl;
+    };
+
+    // List holding the blocks of that size
+    static constexpr index_t mapping(size_t size) {
+        if (size < small_size_) {
+            return {0u, size / (small_size_ / sl_count_)};
+        }
+        const size_t log2 = floor_log2(size);
+        return {log2 - fl_shift_ + 1u, (size >> (log2 - sl_log2_)) ^ sl_count_};
+    }
+
+    // Head of the first non-empty list whose every block fits `size`. When there is none, the head of the list of
+    // `size` itself if it happens to be big enough (the only way to get the biggest blocks), else nullptr.
+    [[nodiscard]] block_t* find_free(size_t size) const {
+        // Rounded up to the next list boundary so any block of the list found fits
+        const size_t rounded = size < small_size_ ? size : size + (size_t{1u} << (floor_log2(size) - sl_log2_)) - 1u;
+
+        if (block_t* block = find_list(rounded); block) {
+            return block;
+        }
+        const auto [fl, sl] = mapping(size);
+        block_t* head = free_lists_[fl][sl];
+        return head && size_of(head) >= size ? head : nullptr;
+    }
+
+    [[nodiscard]] block_t* find_list(size_t size) const {
+        auto [fl, sl] = mapping(size);
+
+        if (fl >= fl_count_) {
+            return nullptr;
+        }
+        std::uint32_t sl_map = sl_bitmaps_[fl] & (~std::uint32_t{0u} << sl);
+
+        if (sl_map == 0u) {
+            const std::uint32_t fl_map = fl + 1u < fl_count_ ? fl_bitmap_ & (~std::uint32_t{0u} << (fl + 1u)) : 0u;
+            if (fl_map == 0u) {
+                return nullptr;
+            }
+            fl = static_cast<size_t>(std::countr_zero(fl_map));
+            sl_map = sl_bitmaps_[fl];
+        }
+        return free_lists_[fl][static_cast<size_t>(std::countr_zero(sl_map))];
+    }
+
+    void insert_free(block_t* block) {
+        const auto [fl, sl] = mapping(size_of(block));
+        block->prev_free = nullptr;
+        block->next_free = free_lists_[fl][sl];
+
+        if (block->next_free) {
+            block->next_free->prev_free = block;
+        }
+        free_lists_[fl][sl] = block;
+        fl_bitmap_ |= std::uint32_t{1u} << fl;
+        sl_bitmaps_[fl] |= std::uint32_t{1u} << sl;
+        free_ += size_of(block);
+    }
+
+    void remove_free(block_t* block) {
+        const auto [fl, sl] = mapping(size_of(block));
+
+        if (block->prev_free) {
+            block->prev_free->next_free = block->next_free;
+        } else {
+            free_lists_[fl][sl] = block->next_free;
+        }
+        if (block->next_free) {
+            block->next_free->prev_free = block->prev_free;
+        }
+        if (!free_lists_[fl][sl]) {
+            sl_bitmaps_[fl] &= ~(std::uint32_t{1u} << sl);
+            if (sl_bitmaps_[fl] == 0u) {
+                fl_bitmap_ &= ~(std::uint32_t{1u} << fl);
+            }
+        }
+        free_ -= size_of(block);
+    }
+
+    // Makes the next physical block point back to this one and tells it whether this one is free
+    void link_next(block_t* block) {
+        block_t* next = next_physical(block);
+        next->prev_physical = block;
+        next->size = (block->size & free_flag_) ? next->size | prev_free_flag_ : next->size & ~prev_free_flag_;
+    }
+
+    static size_t size_of(const block_t* block) { return block->size & ~flags_; }
+
+    static block_t* next_physical(const block_t* block) {
+        return reinterpret_cast<block_t*>(reinterpret_cast<std::uintptr_t>(block) + header_size_ + size_of(block));
+    }
+
+    static void* payload_of(block_t* block) { return reinterpret_cast<std::byte*>(block) + header_size_; }
+
+    // Header of an allocated block, nullptr for a pointer outside the region, misaligned or already free. A pointer
+    // inside the region that was never returned by allocate() is not detected.
+    [[nodiscard]] block_t* block_of(const void* ptr) const {
+        const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        const auto first = reinterpret_cast<std::uintptr_t>(storage_);
+
+        if (!storage_ || address < first + header_size_ || address >= first + NBytes - header_size_ ||
+            (address - first) % align_ != 0u) {
+            return nullptr;
+        }
+        auto* block = reinterpret_cast<block_t*>(address - header_size_);
+        return (block->size & free_flag_) ? nullptr : block;
+    }
+
+    std::byte* storage_ = nullptr;
+    std::uint32_t fl_bitmap_{0u};
+    std::array<std::uint32_t, fl_count_> sl_bitmaps_{};
+    std::array<std::array<block_t*, sl_count_>, fl_count_> free_lists_{};
+    size_t free_{0u};
+};
+
+} // namespace mp
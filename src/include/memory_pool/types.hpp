@@ -1,10 +1,24 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <expected>
+#include <format>
 #include <source_location>
 #include <string>
+#include <string_view>
+#include <utility>
+
+namespace mp {
+
+/**
+ * Assumed size of a cache line, used to keep data shared between threads apart.
+ * std::hardware_destructive_interference_size is avoided because its value may differ between translation units.
+ */
+inline constexpr std::size_t cache_line_size = 64u;
+
+} // namespace mp
 
 namespace mp::error {
 
@@ -18,9 +32,33 @@ enum class code_e : std::uint32_t {
     exception_caught_in_ctor,
     exception_caught_in_dctor,
     out_of_bounds,
-    deallocation_has_failed
+    deallocation_has_failed,
+    invalid_handle,
+    timed_out
+};
+
+#if defined(MP_LEAN_ERRORS)
+
+/**
+ * Lean error channel: only the code travels through std::expected, so a failure costs no more than a success.
+ * The description given at the call site is dropped and never formatted, see describe().
+ */
+struct result_t {
+    code_e code = code_e::ok;
+
+    constexpr result_t() noexcept = default;
+    constexpr result_t(code_e c, std::string_view = {}) noexcept : code{c} {}
+
+    static constexpr auto unexp(result_t result) noexcept { return std::unexpected(result); }
 };
 
+template <typename... TArgs>
+constexpr std::string_view describe(std::format_string<TArgs...>, TArgs&&...) noexcept {
+    return {};
+}
+
+#else
+
 struct result_t {
     code_e code = code_e::ok;
     std::string description = "";
@@ -29,4 +67,14 @@ struct result_t {
     static auto unexp(result_t &&result) { return std::unexpected(std::move(result)); }
 };
 
+/**
+ * Builds the description of an error, only formatted when rich errors are enabled.
+ */
+template <typename... TArgs>
+std::string describe(std::format_string<TArgs...> fmt, TArgs&&... args) {
+    return std::format(fmt, std::forward<TArgs>(args)...);
+}
+
+#endif
+
 } // namespace mp::error
@@ -0,0 +1,194 @@
+
+#pragma once
+
+#include "slot_status_registry.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace mp {
+
+using error::code_e;
+using error::result_t;
+
+/**
+ * T is exactly one of TTypes.
+ */
+template <typename T, typename... TTypes>
+concept OneOf = (std::same_as<T, TTypes> || ...);
+
+/**
+ * One pool shared by a closed set of types with similar lifetimes, so the peaks of the different types share the
+ * same slots instead of each type reserving its own worst case. Every slot is sized and aligned for the largest of
+ * Ts; the type living in a slot is a one-byte tag kept in an array beside the occupancy bitmap, which visit_live()
+ * dispatches on through a table of functions. Same threading rules as mp::allocator.
+ */
+template <size_t NAlloc, std::destructible... Ts>
+    requires(NAlloc > 0u && sizeof...(Ts) > 0u && sizeof...(Ts) <= std::numeric_limits<std::uint8_t>::max())
+class variant_pool final {
+public:
+    variant_pool() = default;
+    variant_pool(const variant_pool&) = delete;
+    variant_pool(variant_pool&&) = delete;
+    variant_pool& operator=(const variant_pool&) = delete;
+    variant_pool& operator=(variant_pool&&) = delete;
+
+    ~variant_pool() { deinitialize(); }
+
+    [[nodiscard]] constexpr bool is_initialized() const { return initialized_.load(std::memory_order_acquire); }
+
+    /**
+     * Reserves the NAlloc slots.
+     */
+    auto initialize() -> std::expected<bool, result_t> {
+        if (is_initialized()) {
+            return result_t::unexp({code_e::already_initialized});
+        }
+        if (storage_ = static_cast<slot_t*>(std::aligned_alloc(alignof(slot_t), sizeof(slot_t) * NAlloc)); !storage_) {
+            return result_t::unexp({code_e::cannot_reserve_system_memory});
+        }
+        initialized_.store(true, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Destroys the live objects and returns the memory to the system.
+     */
+    void deinitialize() {
+        if (is_initialized()) {
+            registry_.for_each_in_use([this](size_t idx) { destroyers_[tags_[idx]](&storage_[idx]); });
+        }
+        initialized_.store(false, std::memory_order_release);
+        registry_.reset();
+        std::free(storage_);
+        storage_ = nullptr;
+    }
+
+    /**
+     * Constructs a T, whichever of Ts, in the first free slot.
+     */
+    template <typename T, typename... TArgs>
+        requires OneOf<T, Ts...>
+    [[nodiscard]] auto allocate(TArgs&&... args) noexcept -> std::expected<T*, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        const size_t idx = registry_.try_fetch();
+
+        if (idx == NAlloc) {
+            return result_t::unexp({code_e::not_enough_space_in_allocator});
+        }
+        try {
+            T* object = ::new (&storage_[idx]) T{std::forward<TArgs>(args)...};
+            tags_[idx] = tag_of<T>;
+            return object;
+        } catch (...) {
+            registry_.release(idx);
+            return result_t::unexp({code_e::exception_caught_in_ctor});
+        }
+    }
+
+    /**
+     * Destroys an object allocated by allocate<T>(), a pointer to a slot holding another type is rejected.
+     */
+    template <typename T>
+        requires OneOf<T, Ts...>
+    auto deallocate(T* allocated) noexcept -> std::expected<bool, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        const size_t idx = index_of(allocated);
+
+        if (idx == NAlloc || !registry_.in_use(idx) || tags_[idx] != tag_of<T>) {
+            return result_t::unexp({code_e::deallocation_has_failed,
+                                    error::describe("variant_pool::deallocate not a live object here idx={}", idx)});
+        }
+        try {
+            std::destroy_at(allocated);
+        } catch (...) {
+            return result_t::unexp({code_e::exception_caught_in_dctor});
+        }
+        registry_.release(idx);
+        return true;
+    }
+
+    /**
+     * Calls fn with every live object, as a reference to its actual type, in address order. fn must accept each of
+     * Ts, typically an overload set or a generic lambda.
+     * @return the number of visited objects
+     */
+    template <typename TFn>
+        requires(std::invocable<TFn&, Ts&> && ...)
+    auto visit_live(TFn&& fn) -> std::expected<size_t, result_t> {
+        if (!is_initialized()) {
+            return result_t::unexp({code_e::not_initialized});
+        }
+        static constexpr std::array<void (*)(TFn&, slot_t*), sizeof...(Ts)> visitors{
+            [](TFn& f, slot_t* slot) { f(*std::launder(reinterpret_cast<Ts*>(slot))); }...};
+        size_t visited{0u};
+
+        registry_.for_each_in_use([&](size_t idx) {
+            visitors[tags_[idx]](fn, &storage_[idx]);
+            ++visited;
+        });
+        return visited;
+    }
+
+    /**
+     * True when ptr is a live T of this pool.
+     */
+    template <typename T>
+        requires OneOf<T, Ts...>
+    [[nodiscard]] bool holds(const T* ptr) const {
+        const size_t idx = index_of(ptr);
+        return idx != NAlloc && registry_.in_use(idx) && tags_[idx] == tag_of<T>;
+    }
+
+    [[nodiscard]] auto status() const { return registry_.status(); }
+
+private:
+    struct alignas(std::max({alignof(Ts)...})) slot_t {
+        std::byte bytes[std::max({sizeof(Ts)...})];
+    };
+
+    // Position of T in Ts
+    template <typename T>
+    static constexpr std::uint8_t tag_of = [] {
+        std::uint8_t tag{0u};
+        std::ignore = ((std::same_as<T, Ts> ? true : (++tag, false)) || ...);
+        return tag;
+    }();
+
+    static constexpr std::array<void (*)(slot_t*), sizeof...(Ts)> destroyers_{
+        [](slot_t* slot) { std::destroy_at(std::launder(reinterpret_cast<Ts*>(slot))); }...};
+
+    // Slot of an address inside the storage, NAlloc for any other address
+    [[nodiscard]] size_t index_of(const void* ptr) const {
+        const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        const auto first = reinterpret_cast<std::uintptr_t>(storage_);
+
+        if (address < first || address >= first + sizeof(slot_t) * NAlloc || (address - first) % sizeof(slot_t) != 0u) {
+            return NAlloc;
+        }
+        return (address - first) / sizeof(slot_t);
+    }
+
+    slot_status_registry<NAlloc> registry_;
+    // Type of the object in each slot, only meaningful for the slots in use
+    std::array<std::uint8_t, NAlloc> tags_{};
+    std::atomic_bool initialized_ = false;
+    slot_t* storage_ = nullptr;
+};
+
+} // namespace mp
@@ -0,0 +1,104 @@
+
+#pragma once
+
+#include "types.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace mp::detail {
+
+/**
+ * Distributes the chunk indexes [0, chunks) between a fixed number of workers. Every worker owns a contiguous
+ * range, pops chunks from its front and, once it runs dry, steals the back half of the first non empty range of
+ * another worker. Each range is packed in a single 64 bits atomic (begin in the low half, end in the high half)
+ * so pop and steal are one compare-exchange each.
+ */
+class work_stealing_ranges final {
+public:
+    work_stealing_ranges(size_t chunks, size_t workers)
+        : workers_{workers == 0u ? 1u : workers}, ranges_{std::make_unique<range_t[]>(workers_)} {
+        const size_t per_worker = chunks / workers_;
+        const size_t remainder = chunks % workers_;
+        size_t begin{0u};
+
+        for (size_t w = 0u; w < workers_; ++w) {
+            const size_t end = begin + per_worker + (w < remainder ? 1u : 0u);
+            ranges_[w].bounds.store(pack(begin, end), std::memory_order_relaxed);
+            begin = end;
+        }
+    }
+
+    [[nodiscard]] size_t workers() const { return workers_; }
+
+    /**
+     * Calls fn(chunk) for every chunk the given worker manages to pop or steal, until no work is left anywhere.
+     */
+    template <typename TFn>
+    void run(size_t worker, TFn&& fn) {
+        size_t chunk{0u};
+
+        for (;;) {
+            while (pop_front(worker, chunk)) {
+                fn(chunk);
+            }
+            if (!steal(worker)) {
+                return;
+            }
+        }
+    }
+
+private:
+    struct alignas(cache_line_size) range_t {
+        std::atomic<std::uint64_t> bounds{0u};
+    };
+
+    static constexpr std::uint64_t pack(size_t begin, size_t end) {
+        return (static_cast<std::uint64_t>(end) << 32u) | static_cast<std::uint32_t>(begin);
+    }
+    static constexpr size_t begin_of(std::uint64_t bounds) { return static_cast<std::uint32_t>(bounds); }
+    static constexpr size_t end_of(std::uint64_t bounds) { return static_cast<size_t>(bounds >> 32u); }
+
+    bool pop_front(size_t worker, size_t& chunk) {
+        auto& bounds = ranges_[worker].bounds;
+        auto current = bounds.load(std::memory_order_acquire);
+
+        while (begin_of(current) < end_of(current)) {
+            if (bounds.compare_exchange_weak(current, pack(begin_of(current) + 1u, end_of(current)),
+                                             std::memory_order_acq_rel)) {
+                chunk = begin_of(current);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Moves the back half of a victim range into the (empty) range of the thief.
+     */
+    bool steal(size_t thief) {
+        for (size_t offset = 1u; offset < workers_; ++offset) {
+            auto& victim = ranges_[(thief + offset) % workers_].bounds;
+            auto current = victim.load(std::memory_order_acquire);
+
+            while (begin_of(current) < end_of(current)) {
+                const size_t begin = begin_of(current);
+                const size_t end = end_of(current);
+                const size_t split = end - (end - begin + 1u) / 2u;
+
+                if (victim.compare_exchange_weak(current, pack(begin, split), std::memory_order_acq_rel)) {
+                    ranges_[thief].bounds.store(pack(split, end), std::memory_order_release);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    size_t workers_;
+    std::unique_ptr<range_t[]> ranges_;
+};
+
+} // namespace mp::detail
@@ -2,12 +2,46 @@
 
 #include <boost/ut.hpp>
 #include <memory_pool/allocator.hpp>
+#include <memory_pool/parallel.hpp>
+
+#include <stdexcept>
 
 struct Parameter {
     std::string id{};
     float value{0.f};
 };
 
+struct Message {
+    std::string payload{};
+    int resets{0};
+
+    void reset() {
+        payload.clear();
+        ++resets;
+    }
+};
+
+template <typename T>
+concept HasStats = requires(T& alloc) { alloc.stats_snapshot(); };
+
+/**
+ * Default constructor throwing once `budget` objects were built, reset() makes it usable in recycle_e::warm mode.
+ */
+struct Throwing {
+    static inline int budget{0};
+    static inline int live{0};
+
+    Throwing() {
+        if (budget-- <= 0) {
+            throw std::runtime_error{"ctor"};
+        }
+        ++live;
+    }
+    Throwing(const Throwing&) = delete;
+    ~Throwing() { --live; }
+    void reset() {}
+};
+
 struct NotDefaultConstructible {
     NotDefaultConstructible() = delete;
 };
@@ -59,6 +93,7 @@ int main() {
 
     "Allocate - Bucket - success"_test = [] {
         mp::allocator<Parameter, 5> alloc;
+        alloc.initialize();
         auto x = alloc.allocate_bucket<3>();
         expect(x.has_value());
         auto bucket = *x;
@@ -83,4 +118,201 @@ int main() {
 
         alloc.deallocate(bucket);
     };
+
+    "Allocate - Bucket - constructor throws"_test = [] {
+        mp::allocator<Throwing, 5> alloc;
+        alloc.initialize();
+        Throwing::budget = 2;
+
+        auto failed = alloc.allocate_bucket<3>();
+        expect(!failed.has_value());
+        expect(failed.error().code == mp::error::code_e::exception_caught_in_ctor);
+        // The two objects built are destroyed and the three slots are free again
+        expect(Throwing::live == 0_i);
+        expect(alloc.status().used == 0_u);
+
+        Throwing::budget = 5;
+        auto bucket = alloc.allocate_bucket<5>();
+        expect(fatal(bucket.has_value()));
+        expect(Throwing::live == 5_i);
+        expect(alloc.deallocate(*bucket).has_value());
+    };
+
+    "Live objects - for_each and range"_test = [] {
+        mp::allocator<Parameter, 70> alloc;
+        expect(!alloc.for_each_live([](Parameter&) {}).has_value());
+        expect(alloc.live().begin() == alloc.live().end());
+
+        alloc.initialize();
+
+        std::vector<Parameter*> allocated;
+        for (int i = 0; i < 70; ++i) {
+            allocated.push_back(*alloc.allocate(std::to_string(i), float(i)));
+        }
+        for (int i = 0; i < 70; ++i) {
+            if (i % 3 != 0) {
+                alloc.deallocate(allocated[i]);
+            }
+        }
+
+        float sum = 0.f;
+        auto visited = alloc.for_each_live<4>([&](Parameter& p) { sum += p.value; });
+        expect(fatal(visited.has_value()));
+        expect(*visited == 24_u);
+        expect(828._f == sum);
+
+        std::vector<std::string> ids;
+        for (auto& p : alloc.live()) {
+            ids.push_back(p.id);
+        }
+        expect(fatal(ids.size() == 24u));
+        expect(ids.front() == "0");
+        expect(ids[1] == "3");
+        expect(ids.back() == "69");
+    };
+
+    "Live objects - parallel for_each"_test = [] {
+        mp::allocator<Parameter, 5000> alloc;
+        expect(!mp::parallel_for_each_live(alloc, [](Parameter&) {}, 4u).has_value());
+
+        alloc.initialize();
+
+        std::vector<Parameter*> allocated;
+        for (int i = 0; i < 5000; ++i) {
+            allocated.push_back(*alloc.allocate("", 1.f));
+        }
+        // Leaves the first chunks almost empty so the other threads have to steal
+        for (int i = 0; i < 2000; ++i) {
+            if (i % 100 != 0) {
+                alloc.deallocate(allocated[i]);
+            }
+        }
+
+        for (size_t threads : {1u, 2u, 4u, 64u}) {
+            std::atomic_int sum{0};
+            auto visited = mp::parallel_for_each_live(alloc, [&](Parameter& p) { sum += int(p.value); }, threads);
+            expect(fatal(visited.has_value()));
+            expect(*visited == 3020_u);
+            expect(sum == 3020);
+        }
+
+        std::atomic_int sum{0};
+        auto visited = mp::parallel_for_each_live(std::execution::par, alloc, [&](Parameter& p) { sum += int(p.value); });
+        expect(fatal(visited.has_value()));
+        expect(*visited == 3020_u);
+        expect(sum == 3020);
+    };
+
+    "Recycle - warm - object kept constructed"_test = [] {
+        mp::allocator<Message, 1, mp::recycle_e::warm> alloc;
+        alloc.initialize();
+
+        auto first = alloc.allocate();
+        expect(fatal(first.has_value()));
+        (*first)->payload.assign(1000, 'x');
+        const auto capacity = (*first)->payload.capacity();
+
+        expect(alloc.deallocate(*first).has_value());
+        expect(alloc.status().used == 0_u);
+
+        auto second = alloc.allocate();
+        expect(fatal(second.has_value()));
+        expect(*second == *first);
+        expect((*second)->payload.empty());
+        expect((*second)->payload.capacity() == capacity);
+        expect((*second)->resets == 1);
+    };
+
+    "Recycle - warm - constructor throws during initialize"_test = [] {
+        mp::allocator<Throwing, 4, mp::recycle_e::warm> alloc;
+        Throwing::budget = 2;
+
+        auto failed = alloc.initialize();
+        expect(!failed.has_value());
+        expect(failed.error().code == mp::error::code_e::exception_caught_in_ctor);
+        expect(!alloc.is_initialized());
+
+        // The storage of the failed attempt is not leaked by the retry
+        Throwing::budget = 4;
+        expect(alloc.initialize().has_value());
+        expect(alloc.allocate().has_value());
+    };
+
+    "Fast path - try_allocate / deallocate_unchecked"_test = [] {
+        mp::allocator<Parameter, 2> alloc;
+        alloc.initialize();
+
+        static_assert(noexcept(alloc.try_allocate()));
+        static_assert(noexcept(alloc.deallocate_unchecked(nullptr)));
+
+        Parameter* a = alloc.try_allocate();
+        Parameter* b = alloc.try_allocate();
+        expect(fatal(a != nullptr && b != nullptr));
+        expect(alloc.try_allocate() == nullptr);
+        expect(alloc.status().used == 2_u);
+
+        alloc.deallocate_unchecked(a);
+        expect(alloc.status().used == 1_u);
+
+        Parameter* c = alloc.try_allocate();
+        expect(c == a);
+        expect(c->id.empty());
+
+        // The checked and unchecked paths share the same bookkeeping
+        expect(alloc.deallocate(c).has_value());
+        alloc.deallocate_unchecked(b);
+        expect(alloc.status().used == 0_u);
+    };
+
+    "Pool - created initialized"_test = [] {
+        auto created = mp::allocator<Parameter, 2>::create();
+        expect(fatal(created.has_value()));
+
+        mp::pool<Parameter, 2> pool = std::move(*created);
+
+        auto a = pool.allocate("A", 1.f);
+        expect(fatal(a.has_value()));
+        expect((*a)->id == "A");
+
+        auto bucket = pool.allocate_bucket<1>();
+        expect(fatal(bucket.has_value()));
+        expect(bucket->size() == 1_u);
+
+        auto full = pool.allocate();
+        expect(!full.has_value());
+        expect(full.error().code == mp::error::code_e::not_enough_space_in_allocator);
+
+        expect(pool.deallocate(*bucket).has_value());
+        expect(pool.deallocate(*a).has_value());
+        expect(pool.status().used == 0_u);
+    };
+
+    "Pool - moved keeps the objects"_test = [] {
+        auto pool = *mp::pool<Parameter, 4>::create();
+        Parameter* p = *pool.allocate("kept", 2.f);
+
+        auto moved = std::move(pool);
+        expect(moved.status().used == 1_u);
+
+        size_t live = 0u;
+        for (auto& obj : moved.live()) {
+            expect(&obj == p);
+            ++live;
+        }
+        expect(live == 1_u);
+        expect(mp::parallel_for_each_live(moved, [&](Parameter& obj) { expect(&obj == p); }, 2u) == 1u);
+        expect(moved.deallocate(p).has_value());
+    };
+
+#if defined(MP_STATS)
+    "Stats - enabled with MP_STATS"_test = [] {
+        expect(!std::is_empty_v<mp::detail::stats_recorder>);
+        expect(HasStats<mp::allocator<Parameter, 1>>);
+    };
+#else
+    "Stats - compiled out by default"_test = [] {
+        expect(std::is_empty_v<mp::detail::stats_recorder>);
+        expect(!HasStats<mp::allocator<Parameter, 1>>);
+    };
+#endif
 }
@@ -0,0 +1,150 @@
+#include "memory_pool/types.hpp"
+
+#include <boost/ut.hpp>
+#include <memory_pool/arena.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct Tracked {
+    static inline std::vector<int> destroyed{};
+
+    int id{0};
+
+    explicit Tracked(int i) : id{i} {}
+    ~Tracked() { destroyed.push_back(id); }
+};
+
+struct Throwing {
+    Throwing() { throw std::runtime_error{"ctor"}; }
+    ~Throwing() {}
+};
+
+struct alignas(64) Wide {
+    std::uint64_t value{0u};
+};
+
+int main() {
+    using namespace boost::ut;
+
+    "Allocate - not initialized"_test = [] {
+        mp::arena<256> arena;
+
+        auto result = arena.allocate(16u);
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::not_initialized);
+        expect(!arena.make<int>(1).has_value());
+    };
+
+    "Initialize - twice"_test = [] {
+        mp::arena<256> arena;
+        expect(arena.initialize().has_value());
+
+        auto again = arena.initialize();
+        expect(!again.has_value());
+        expect(again.error().code == mp::error::code_e::already_initialized);
+    };
+
+    "Allocate - alignment"_test = [] {
+        mp::arena<1024> arena;
+        expect(fatal(arena.initialize().has_value()));
+
+        auto a = arena.allocate(1u, 1u);
+        auto b = arena.allocate(8u, 64u);
+        auto c = arena.allocate(3u, 16u);
+        expect(fatal(a.has_value() && b.has_value() && c.has_value()));
+        expect(reinterpret_cast<std::uintptr_t>(*b) % 64u == 0_u);
+        expect(reinterpret_cast<std::uintptr_t>(*c) % 16u == 0_u);
+        expect(arena.owns(*a) && arena.owns(*b) && arena.owns(*c));
+        expect(arena.status().used == 64_u + 8_u + 8_u + 3_u);
+
+        auto bad = arena.allocate(8u, 24u);
+        expect(!bad.has_value());
+        expect(bad.error().code == mp::error::code_e::bad_logic);
+    };
+
+    "Allocate - exhausted"_test = [] {
+        mp::arena<128> arena;
+        expect(fatal(arena.initialize().has_value()));
+
+        expect(arena.allocate(100u, 1u).has_value());
+        auto full = arena.allocate(29u, 1u);
+        expect(!full.has_value());
+        expect(full.error().code == mp::error::code_e::not_enough_space_in_allocator);
+        expect(arena.status().used == 100_u);
+
+        expect(arena.allocate(28u, 1u).has_value());
+        expect(arena.status().free == 0_u);
+    };
+
+    "Make - trivially destructible objects take only their size"_test = [] {
+        mp::arena<256> arena;
+        expect(fatal(arena.initialize().has_value()));
+
+        auto value = arena.make<std::uint64_t>(42u);
+        expect(fatal(value.has_value()));
+        expect(**value == 42_u);
+        expect(arena.status().used == 8_u);
+
+        auto wide = arena.make<Wide>();
+        expect(fatal(wide.has_value()));
+        expect(reinterpret_cast<std::uintptr_t>(*wide) % 64u == 0_u);
+    };
+
+    "Reset - destroys in reverse order and rewinds"_test = [] {
+        Tracked::destroyed.clear();
+        mp::arena<512> arena;
+        expect(fatal(arena.initialize().has_value()));
+
+        auto first = arena.make<Tracked>(1);
+        expect(arena.make<int>(7).has_value());
+        auto second = arena.make<Tracked>(2);
+        auto text = arena.make<std::string>("a string long enough to own a heap buffer");
+        expect(fatal(first.has_value() && second.has_value() && text.has_value()));
+        expect((*second)->id == 2_i);
+
+        arena.reset();
+        expect(Tracked::destroyed == std::vector<int>{2, 1});
+        expect(arena.status().used == 0_u);
+        expect(!arena.owns(*first));
+
+        // The storage is reused from the start
+        auto again = arena.make<Tracked>(3);
+        expect(fatal(again.has_value()));
+        expect(arena.owns(*again));
+    };
+
+    "Make - constructor throws"_test = [] {
+        mp::arena<256> arena;
+        expect(fatal(arena.initialize().has_value()));
+        expect(arena.allocate(4u, 1u).has_value());
+
+        auto result = arena.make<Throwing>();
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::exception_caught_in_ctor);
+        expect(arena.status().used == 4_u);
+        arena.reset();
+    };
+
+    "Make - no room for the object releases its destructor record"_test = [] {
+        mp::arena<32> arena;
+        expect(fatal(arena.initialize().has_value()));
+
+        auto result = arena.make<std::string>();
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::not_enough_space_in_allocator);
+        expect(arena.status().used == 0_u);
+    };
+
+    "Deinitialize - destroys the live objects"_test = [] {
+        Tracked::destroyed.clear();
+        {
+            mp::arena<256> arena;
+            expect(fatal(arena.initialize().has_value()));
+            expect(arena.make<Tracked>(5).has_value());
+        }
+        expect(Tracked::destroyed == std::vector<int>{5});
+    };
+}
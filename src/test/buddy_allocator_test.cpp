@@ -0,0 +1,135 @@
+#include "memory_pool/types.hpp"
+
+#include <boost/ut.hpp>
+#include <memory_pool/buddy_allocator.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+int main() {
+    using namespace boost::ut;
+
+    "Allocate - not initialized"_test = [] {
+        mp::buddy_allocator<64, 1024> buddy;
+
+        auto result = buddy.allocate(64u);
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::not_initialized);
+    };
+
+    "Allocate - rounds up to a power of two"_test = [] {
+        mp::buddy_allocator<64, 1024> buddy;
+        expect(fatal(buddy.initialize().has_value()));
+        static_assert(decltype(buddy)::orders == 5u);
+
+        auto tiny = buddy.allocate(0u);
+        auto odd = buddy.allocate(100u);
+        auto exact = buddy.allocate(256u);
+        expect(fatal(tiny.has_value() && odd.has_value() && exact.has_value()));
+        expect(buddy.block_size(*tiny) == 64_u);
+        expect(buddy.block_size(*odd) == 128_u);
+        expect(buddy.block_size(*exact) == 256_u);
+        expect(buddy.status().used == 448_u);
+
+        // Every block is aligned on its size relatively to the region
+        expect(reinterpret_cast<std::uintptr_t>(*exact) % 256u == 0_u);
+        expect(reinterpret_cast<std::uintptr_t>(*odd) % 128u == 0_u);
+    };
+
+    "Allocate - too big or exhausted"_test = [] {
+        mp::buddy_allocator<64, 1024, 2> buddy;
+        expect(fatal(buddy.initialize().has_value()));
+
+        auto big = buddy.allocate(1025u);
+        expect(!big.has_value());
+        expect(big.error().code == mp::error::code_e::out_of_bounds);
+
+        auto a = buddy.allocate(1024u);
+        auto b = buddy.allocate(1024u);
+        expect(fatal(a.has_value() && b.has_value()));
+        expect(buddy.largest_free_block() == 0_u);
+
+        auto full = buddy.allocate(1u);
+        expect(!full.has_value());
+        expect(full.error().code == mp::error::code_e::not_enough_space_in_allocator);
+    };
+
+    "Deallocate - buddies merge back"_test = [] {
+        mp::buddy_allocator<64, 1024> buddy;
+        expect(fatal(buddy.initialize().has_value()));
+
+        std::vector<void*> blocks;
+        for (size_t i = 0u; i < 16u; ++i) {
+            auto block = buddy.allocate(64u);
+            expect(fatal(block.has_value()));
+            blocks.push_back(*block);
+        }
+        expect(buddy.largest_free_block() == 0_u);
+
+        // Every other block free: 512 bytes free, but no two free buddies
+        for (size_t i = 0u; i < blocks.size(); i += 2u) {
+            expect(buddy.deallocate(blocks[i]).has_value());
+        }
+        expect(buddy.status().free == 512_u);
+        expect(buddy.largest_free_block() == 64_u);
+        expect(buddy.free_blocks(64u) == 8_u);
+        expect(buddy.free_blocks(100u) == 0_u);
+
+        for (size_t i = 1u; i < blocks.size(); i += 2u) {
+            expect(buddy.deallocate(blocks[i]).has_value());
+        }
+        expect(buddy.status().used == 0_u);
+        expect(buddy.largest_free_block() == 1024_u);
+    };
+
+    "Deallocate - foreign pointer and double free"_test = [] {
+        mp::buddy_allocator<64, 1024> buddy;
+        expect(fatal(buddy.initialize().has_value()));
+        int outsider{0};
+
+        auto foreign = buddy.deallocate(&outsider);
+        expect(!foreign.has_value());
+        expect(foreign.error().code == mp::error::code_e::deallocation_has_failed);
+
+        auto block = buddy.allocate(128u);
+        expect(fatal(block.has_value()));
+        expect(!buddy.deallocate(static_cast<std::byte*>(*block) + 64).has_value());
+        expect(buddy.deallocate(*block).has_value());
+        expect(!buddy.deallocate(*block).has_value());
+        expect(buddy.block_size(*block) == 0_u);
+    };
+
+    "Random workload - blocks never overlap and the region comes back whole"_test = [] {
+        mp::buddy_allocator<64, 4096, 4> buddy;
+        expect(fatal(buddy.initialize().has_value()));
+        std::mt19937 rng{7u};
+        std::vector<std::pair<std::byte*, size_t>> live;
+
+        for (size_t step = 0u; step < 5000u; ++step) {
+            if (live.empty() || rng() % 3u != 0u) {
+                const size_t bytes = 1u + rng() % 4096u;
+                if (auto block = buddy.allocate(bytes); block) {
+                    live.emplace_back(static_cast<std::byte*>(*block), buddy.block_size(*block));
+                    expect(live.back().second >= bytes);
+                }
+            } else {
+                const size_t victim = rng() % live.size();
+                expect(buddy.deallocate(live[victim].first).has_value());
+                live[victim] = live.back();
+                live.pop_back();
+            }
+        }
+        std::ranges::sort(live);
+        for (size_t i = 1u; i < live.size(); ++i) {
+            expect(live[i - 1u].first + live[i - 1u].second <= live[i].first);
+        }
+        for (auto [block, size] : live) {
+            expect(buddy.deallocate(block).has_value());
+        }
+        expect(buddy.status().used == 0_u);
+        expect(buddy.largest_free_block() == 4096_u);
+    };
+}
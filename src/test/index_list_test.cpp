@@ -0,0 +1,140 @@
+#include "memory_pool/allocator.hpp"
+
+#include <boost/ut.hpp>
+#include <memory_pool/index_list.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+constexpr size_t small_pool = 64u;
+
+struct Task {
+    int id{0};
+    mp::list_hook_t<small_pool> link{};
+    mp::slist_hook_t<small_pool> ready{};
+};
+
+template <typename TContainer>
+std::vector<int> ids(const TContainer& container) {
+    std::vector<int> result;
+    for (const Task& task : container) {
+        result.push_back(task.id);
+    }
+    return result;
+}
+
+int main() {
+    using namespace boost::ut;
+    using list_t = mp::index_list<Task, small_pool, &Task::link>;
+    using queue_t = mp::index_queue<Task, small_pool, &Task::ready>;
+    using stack_t = mp::index_stack<Task, small_pool, &Task::ready>;
+
+    static_assert(std::is_same_v<mp::slot_index_t<65535u>, std::uint16_t>);
+    static_assert(std::is_same_v<mp::slot_index_t<65536u>, std::uint32_t>);
+    static_assert(sizeof(mp::list_hook_t<small_pool>) == 4u);
+    static_assert(sizeof(mp::list_hook_t<100'000u>) == 8u);
+    static_assert(std::forward_iterator<list_t::iterator>);
+
+    "Allocator - index_of and from_index"_test = [] {
+        mp::allocator<Task, small_pool> alloc;
+        expect(fatal(alloc.initialize().has_value()));
+
+        Task* task = *alloc.allocate();
+        const size_t idx = alloc.index_of(task);
+        expect(idx < small_pool);
+        expect(alloc.from_index(idx) == task);
+
+        Task outsider;
+        expect(alloc.index_of(&outsider) == small_pool);
+    };
+
+    "List - push, insert, erase"_test = [] {
+        mp::allocator<Task, small_pool> alloc;
+        expect(fatal(alloc.initialize().has_value()));
+        list_t list{alloc};
+        expect(list.empty());
+        expect(list.pop_front() == nullptr);
+
+        std::vector<Task*> tasks;
+        for (int i = 0; i < 5; ++i) {
+            tasks.push_back(*alloc.allocate(Task{.id = i}));
+        }
+        list.push_back(*tasks[1]);
+        list.push_back(*tasks[3]);
+        list.push_front(*tasks[0]);
+        list.insert(std::next(list.begin(), 2), *tasks[2]);
+        list.insert(list.end(), *tasks[4]);
+        expect(list.size() == 5_u);
+        expect(ids(list) == std::vector{0, 1, 2, 3, 4});
+
+        list.erase(*tasks[2]);
+        list.erase(*tasks[0]);
+        list.erase(*tasks[4]);
+        expect(ids(list) == std::vector{1, 3});
+        expect(list.front() == tasks[1]);
+        expect(list.back() == tasks[3]);
+
+        expect(list.pop_back() == tasks[3]);
+        expect(list.pop_front() == tasks[1]);
+        expect(list.empty());
+        expect(list.back() == nullptr);
+        // Unlinking does not deallocate
+        expect(alloc.status().used == 5_u);
+    };
+
+    "Queue and stack - order, sharing a hook with the list"_test = [] {
+        auto pool = *mp::pool<Task, small_pool>::create();
+        list_t all{pool};
+        queue_t queue{pool};
+        stack_t stack{pool};
+
+        for (int i = 0; i < 4; ++i) {
+            Task* task = *pool.allocate(Task{.id = i});
+            all.push_back(*task);
+            queue.push(*task);
+        }
+        expect(ids(queue) == std::vector{0, 1, 2, 3});
+        expect(queue.back()->id == 3_i);
+
+        // The ready hook moves the tasks from the queue to the stack, the list is not affected
+        while (Task* task = queue.pop()) {
+            stack.push(*task);
+        }
+        expect(queue.empty());
+        expect(queue.front() == nullptr);
+        expect(ids(stack) == std::vector{3, 2, 1, 0});
+        expect(ids(all) == std::vector{0, 1, 2, 3});
+
+        expect(stack.pop()->id == 3_i);
+        expect(stack.top()->id == 2_i);
+        expect(stack.size() == 3_u);
+        stack.clear();
+        expect(stack.pop() == nullptr);
+
+        // Emptied and filled again
+        queue.push(*all.front());
+        expect(queue.front() == queue.back());
+    };
+
+    "List - 32-bit links past 65535 slots"_test = [] {
+        struct Wide {
+            mp::list_hook_t<70'000u> link{};
+        };
+        auto alloc = std::make_unique<mp::allocator<Wide, 70'000u>>();
+        expect(fatal(alloc->initialize().has_value()));
+        mp::index_list<Wide, 70'000u, &Wide::link> list{*alloc};
+
+        std::vector<Wide*> nodes;
+        while (Wide* node = alloc->try_allocate()) {
+            nodes.push_back(node);
+        }
+        expect(nodes.size() == 70'000_u);
+        list.push_back(*nodes.back());
+        list.push_front(*nodes[65'535u]);
+        expect(list.front() == nodes[65'535u]);
+        expect(alloc->index_of(list.back()) == 69'999_u);
+        expect(std::distance(list.begin(), list.end()) == 2_i);
+    };
+}
@@ -0,0 +1,177 @@
+#include "memory_pool/types.hpp"
+
+#include <boost/ut.hpp>
+#include <memory_pool/io_buffer_pool.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+int main() {
+    using namespace boost::ut;
+    using pool_t = mp::io_buffer_pool<4096, 4>;
+
+    "Acquire - not initialized"_test = [] {
+        pool_t pool;
+
+        auto result = pool.acquire();
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::not_initialized);
+    };
+
+    "Acquire - page-aligned blocks until exhaustion"_test = [] {
+        pool_t pool;
+        expect(fatal(pool.initialize().has_value()));
+        std::vector<pool_t::buffer> buffers;
+
+        for (size_t i = 0u; i < 4u; ++i) {
+            auto buf = pool.acquire();
+            expect(fatal(buf.has_value()));
+            expect(reinterpret_cast<std::uintptr_t>(buf->data()) % 4096u == 0_u);
+            expect(buf->size() == 0_u);
+            expect(buf->writable().size() == 4096_u);
+            buffers.push_back(std::move(*buf));
+        }
+        auto full = pool.acquire();
+        expect(!full.has_value());
+        expect(full.error().code == mp::error::code_e::not_enough_space_in_allocator);
+
+        buffers.pop_back();
+        expect(pool.acquire().has_value());
+    };
+
+    "Buffer - copies share the block until the last one"_test = [] {
+        pool_t pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        auto first = pool.acquire();
+        expect(fatal(first.has_value()));
+        first->resize(100u);
+        {
+            pool_t::buffer second = *first;
+            pool_t::buffer third = second;
+            expect(first->use_count() == 3_u);
+            expect(second.data() == first->data());
+            expect(second.size() == 100_u);
+
+            third.resize(10u);
+            expect(second.size() == 100_u);
+            third.reset();
+            expect(!third);
+            expect(first->use_count() == 2_u);
+        }
+        expect(first->use_count() == 1_u);
+        expect(pool.status().used == 1_u);
+
+        pool_t::buffer moved = std::move(*first);
+        expect(!*first);
+        expect(moved.use_count() == 1_u);
+        moved.reset();
+        expect(pool.status().used == 0_u);
+    };
+
+    "Buffer - copies dropped on other threads"_test = [] {
+        constexpr int threads = 4;
+        constexpr int rounds = 500;
+        pool_t pool;
+        expect(fatal(pool.initialize().has_value()));
+        std::atomic_int mismatches{0};
+        {
+            // Every thread acquires its own blocks and receives copies of the blocks of the others
+            std::vector<std::jthread> workers;
+            for (int t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t] {
+                    for (int round = 0; round < rounds; ++round) {
+                        auto buf = pool.acquire();
+                        if (!buf) {
+                            continue;
+                        }
+                        buf->writable()[0] = std::byte(t);
+                        buf->resize(1u);
+                        std::jthread peer{[copy = *buf, t, &mismatches] {
+                            if (copy.readable()[0] != std::byte(t)) {
+                                ++mismatches;
+                            }
+                        }};
+                        // Whichever of the two drops its reference last releases the block
+                        buf->reset();
+                    }
+                });
+            }
+        }
+        expect(mismatches.load() == 0_i);
+        expect(pool.status().used == 0_u);
+    };
+
+    "Iovec - readv fills the buffers in order and writev sends them back"_test = [] {
+        mp::io_buffer_pool<2048, 4> pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        std::array<int, 2> fds{};
+        expect(fatal(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()) == 0));
+
+        std::vector<char> message(3000u);
+        for (size_t i = 0u; i < message.size(); ++i) {
+            message[i] = static_cast<char>('a' + i % 26u);
+        }
+        expect(fatal(::write(fds[0], message.data(), message.size()) == static_cast<ssize_t>(message.size())));
+
+        std::vector<mp::io_buffer_pool<2048, 4>::buffer> buffers;
+        buffers.push_back(*pool.acquire());
+        buffers.push_back(*pool.acquire());
+        std::array<iovec, 4> iov{};
+
+        size_t reading = pool.writable_iovecs(buffers, iov);
+        expect(reading == 2_u);
+        size_t received{0u};
+        while (received < message.size()) {
+            const auto n = ::readv(fds[1], iov.data(), static_cast<int>(reading));
+            expect(fatal(n > 0));
+            expect(pool.commit(buffers, static_cast<size_t>(n)) == 0_u);
+            received += static_cast<size_t>(n);
+            reading = pool.writable_iovecs(buffers, iov);
+        }
+        expect(buffers[0].size() == 2048_u);
+        expect(buffers[1].size() == 952_u);
+
+        const size_t writing = pool.readable_iovecs(buffers, iov);
+        expect(writing == 2_u);
+        expect(::writev(fds[1], iov.data(), static_cast<int>(writing)) == static_cast<ssize_t>(message.size()));
+
+        std::vector<char> echoed(message.size());
+        size_t read{0u};
+        while (read < echoed.size()) {
+            const auto n = ::read(fds[0], echoed.data() + read, echoed.size() - read);
+            expect(fatal(n > 0));
+            read += static_cast<size_t>(n);
+        }
+        expect(echoed == message);
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+    };
+
+    "Iovec - empty and full buffers are skipped"_test = [] {
+        pool_t pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        std::vector<pool_t::buffer> buffers;
+        buffers.push_back(*pool.acquire());
+        buffers.push_back(*pool.acquire());
+        buffers[0].resize(4096u);
+        std::array<iovec, 2> iov{};
+
+        expect(pool.readable_iovecs(buffers, iov) == 1_u);
+        expect(iov[0].iov_base == buffers[0].data());
+        expect(pool.writable_iovecs(buffers, iov) == 1_u);
+        expect(iov[0].iov_base == buffers[1].data());
+        expect(pool.commit(buffers, 5000u) == 904_u);
+    };
+}
@@ -0,0 +1,97 @@
+#ifndef MP_LATENCY
+#define MP_LATENCY
+#endif
+
+#include "memory_pool/types.hpp"
+
+#include <boost/ut.hpp>
+#include <memory_pool/allocator.hpp>
+#include <memory_pool/latency.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Parameter {
+    std::string id{};
+    float value{0.f};
+};
+
+int main() {
+    using namespace boost::ut;
+
+    "Histogram - buckets"_test = [] {
+        using histogram_t = mp::latency_histogram;
+
+        expect(histogram_t::bucket_of(0u) == 0_u);
+        expect(histogram_t::bucket_of(31u) == 31_u);
+        expect(histogram_t::bucket_of(32u) == 32_u);
+        expect(histogram_t::bucket_of(33u) == 32_u);
+        expect(histogram_t::bucket_of(~std::uint64_t{0u}) == histogram_t::bucket_count - 1u);
+
+        for (std::uint64_t value : {1ull, 40ull, 1000ull, 123456ull, 1ull << 40u}) {
+            const auto bucket = histogram_t::bucket_of(value);
+            expect(histogram_t::upper_bound_of(bucket) >= value);
+            expect(histogram_t::bucket_of(histogram_t::upper_bound_of(bucket)) == bucket);
+        }
+    };
+
+    "Histogram - percentiles and merge"_test = [] {
+        mp::latency_histogram a;
+        mp::latency_histogram b;
+
+        for (std::uint64_t i = 1u; i <= 990u; ++i) {
+            a.record(10u);
+        }
+        for (std::uint64_t i = 1u; i <= 10u; ++i) {
+            b.record(10'000u);
+        }
+        a.merge(b);
+
+        expect(a.count() == 1000_u);
+        expect(a.percentile(50.0) == 10_u);
+        expect(a.percentile(98.9) == 10_u);
+        expect(a.percentile(99.9) == 10'000_u);
+        expect(a.max() == 10'000_u);
+        expect(a.min() == 10_u);
+    };
+
+    "Allocator - allocate and deallocate are timed"_test = [] {
+        auto pool = *mp::pool<Parameter, 64>::create();
+
+        std::vector<Parameter*> allocated;
+        for (int i = 0; i < 64; ++i) {
+            allocated.push_back(*pool.allocate());
+        }
+        std::ignore = pool.allocate();
+        for (auto* p : allocated) {
+            std::ignore = pool.deallocate(p);
+        }
+
+        const auto report = pool.latency_snapshot();
+        expect(report.allocate.count() == 65_u);
+        expect(report.deallocate.count() == 64_u);
+        expect(report.allocate.percentile(99.9) >= report.allocate.percentile(50.0));
+        expect(report.to_string().starts_with("allocate: count=65 "));
+    };
+
+    "Recorder - more threads than shards"_test = [] {
+        mp::detail::latency_recorder recorder;
+        constexpr size_t threads = 2u * mp::detail::stats_shards;
+        constexpr size_t samples = 1000u;
+        {
+            std::vector<std::jthread> workers;
+            for (size_t t = 0u; t < threads; ++t) {
+                workers.emplace_back([&] {
+                    for (size_t i = 0u; i < samples; ++i) {
+                        const auto timer = recorder.time(mp::detail::latency_recorder::op_e::allocate);
+                    }
+                });
+            }
+        }
+        const auto report = recorder.snapshot();
+        expect(report.allocate.count() == threads * samples);
+        expect(report.deallocate.count() == 0_u);
+        expect(report.allocate.min() <= report.allocate.max());
+    };
+}
@@ -0,0 +1,50 @@
+#ifndef MP_LEAN_ERRORS
+#define MP_LEAN_ERRORS
+#endif
+
+#include "memory_pool/types.hpp"
+
+#include <boost/ut.hpp>
+#include <memory_pool/allocator.hpp>
+#include <memory_pool/slot_map.hpp>
+
+#include <string>
+
+struct Parameter {
+    std::string id{};
+    float value{0.f};
+};
+
+int main() {
+    using namespace boost::ut;
+
+    "Lean - only the code is carried"_test = [] {
+        expect(sizeof(mp::error::result_t) == sizeof(mp::error::code_e));
+        expect(std::is_trivially_copyable_v<mp::error::result_t>);
+        expect(mp::error::describe("ignored {}", 42).empty());
+    };
+
+    "Lean - allocate - fail - no space left"_test = [] {
+        mp::allocator<Parameter, 1> alloc;
+
+        auto result = alloc.allocate();
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::not_initialized);
+
+        alloc.initialize();
+        expect(alloc.allocate().has_value());
+
+        result = alloc.allocate();
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::not_enough_space_in_allocator);
+    };
+
+    "Lean - formatted errors keep their code"_test = [] {
+        mp::slot_map<Parameter, 1> map;
+        map.initialize();
+
+        auto result = map.deallocate(mp::handle_t{.index = 0u, .generation = 3u});
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::invalid_handle);
+    };
+}
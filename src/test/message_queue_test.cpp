@@ -0,0 +1,183 @@
+#include "memory_pool/types.hpp"
+
+#include <boost/ut.hpp>
+#include <memory_pool/message_queue.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Message {
+    static inline std::atomic_int alive{0};
+
+    std::uint32_t producer{0u};
+    std::uint64_t sequence{0u};
+    std::string text{};
+
+    Message(std::uint32_t p, std::uint64_t s, std::string t = {}) : producer{p}, sequence{s}, text{std::move(t)} {
+        ++alive;
+    }
+    ~Message() { --alive; }
+};
+
+struct Throwing {
+    explicit Throwing(bool fail) {
+        if (fail) {
+            throw std::runtime_error{"ctor"};
+        }
+    }
+};
+
+int main() {
+    using namespace boost::ut;
+
+    "Emplace - not initialized"_test = [] {
+        mp::message_queue<Message, 4> queue;
+
+        auto result = queue.emplace(1u, 1u);
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::not_initialized);
+        expect(queue.try_pop() == nullptr);
+        expect(!queue.consume([](Message&) {}));
+    };
+
+    "Emplace - fifo and zero copy"_test = [] {
+        mp::message_queue<Message, 4> queue;
+        expect(fatal(queue.initialize().has_value()));
+        expect(queue.try_pop() == nullptr);
+
+        expect(queue.emplace(1u, 10u, "first").has_value());
+        expect(queue.emplace(1u, 11u, "second").has_value());
+
+        Message* first = queue.try_pop();
+        expect(fatal(first != nullptr));
+        expect(first->text == "first");
+        queue.release(first);
+
+        expect(queue.consume([](Message& m) { expect(m.sequence == 11_u); }));
+        expect(!queue.consume([](Message&) {}));
+        expect(Message::alive == 0_i);
+    };
+
+    "Emplace - full while consumers hold the slots"_test = [] {
+        mp::message_queue<Message, 2> queue;
+        expect(fatal(queue.initialize().has_value()));
+
+        expect(queue.emplace(1u, 1u).has_value());
+        expect(queue.emplace(1u, 2u).has_value());
+        auto full = queue.emplace(1u, 3u);
+        expect(!full.has_value());
+        expect(full.error().code == mp::error::code_e::not_enough_space_in_allocator);
+
+        // Popped but not released yet: the slot is still taken
+        Message* held = queue.try_pop();
+        expect(!queue.emplace(1u, 3u).has_value());
+        queue.release(held);
+        expect(queue.emplace(1u, 3u).has_value());
+    };
+
+    "Emplace - constructor throws"_test = [] {
+        mp::message_queue<Throwing, 2> queue;
+        expect(fatal(queue.initialize().has_value()));
+
+        auto result = queue.emplace(true);
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::exception_caught_in_ctor);
+        expect(queue.try_pop() == nullptr);
+
+        // The slot is not lost
+        expect(queue.emplace(false).has_value());
+        expect(queue.emplace(false).has_value());
+    };
+
+    "Deinitialize - destroys the queued messages"_test = [] {
+        {
+            mp::message_queue<Message, 8, mp::queue_e::mpmc> queue;
+            expect(fatal(queue.initialize().has_value()));
+            expect(queue.emplace(1u, 1u, "a string long enough to own a heap buffer").has_value());
+            expect(queue.emplace(1u, 2u).has_value());
+            expect(Message::alive == 2_i);
+        }
+        expect(Message::alive == 0_i);
+    };
+
+    "SPSC - every message arrives once and in order"_test = [] {
+        auto queue = std::make_unique<mp::message_queue<Message, 64>>();
+        expect(fatal(queue->initialize().has_value()));
+        constexpr std::uint64_t count = 100'000u;
+        bool ordered{true};
+
+        std::jthread consumer{[&] {
+            for (std::uint64_t expected = 0u; expected < count;) {
+                if (!queue->consume([&](Message& m) { ordered = ordered && m.sequence == expected; })) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                ++expected;
+            }
+        }};
+        for (std::uint64_t i = 0u; i < count;) {
+            if (queue->emplace(0u, i)) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        consumer.join();
+        expect(ordered);
+        expect(Message::alive == 0_i);
+    };
+
+    "MPMC - every message arrives once, in order per producer"_test = [] {
+        auto queue = std::make_unique<mp::message_queue<Message, 64, mp::queue_e::mpmc>>();
+        expect(fatal(queue->initialize().has_value()));
+        constexpr std::uint32_t producers = 4u;
+        constexpr std::uint32_t consumers = 4u;
+        constexpr std::uint64_t per_producer = 20'000u;
+        std::atomic_uint64_t received{0u};
+        std::atomic_uint64_t sum{0u};
+        std::atomic_bool ordered{true};
+
+        {
+            std::vector<std::jthread> threads;
+            for (std::uint32_t c = 0u; c < consumers; ++c) {
+                threads.emplace_back([&] {
+                    std::vector<std::uint64_t> last(producers, 0u);
+                    while (received.load() < producers * per_producer) {
+                        const bool got = queue->consume([&](Message& m) {
+                            // With several consumers only the sequences seen by one consumer are ordered
+                            if (m.sequence + 1u < last[m.producer]) {
+                                ordered = false;
+                            }
+                            last[m.producer] = m.sequence + 1u;
+                            sum += m.sequence;
+                            ++received;
+                        });
+                        if (!got) {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+            }
+            for (std::uint32_t p = 0u; p < producers; ++p) {
+                threads.emplace_back([&, p] {
+                    for (std::uint64_t i = 0u; i < per_producer;) {
+                        if (queue->emplace(p, i)) {
+                            ++i;
+                        } else {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+            }
+        }
+        expect(received.load() == producers * per_producer);
+        expect(sum.load() == producers * (per_producer * (per_producer - 1u) / 2u));
+        expect(ordered.load());
+        expect(Message::alive == 0_i);
+    };
+}
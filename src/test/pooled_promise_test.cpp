@@ -0,0 +1,149 @@
+#include "memory_pool/types.hpp"
+
+#include <boost/ut.hpp>
+#include <memory_pool/pooled_promise.hpp>
+
+#include <array>
+#include <coroutine>
+#include <exception>
+#include <thread>
+#include <vector>
+
+/**
+ * Lazy coroutine returning an int, the frame lives until the task is destroyed.
+ */
+template <typename TPromiseBase>
+struct Task {
+    struct promise_type : TPromiseBase {
+        int value{0};
+
+        Task get_return_object() { return Task{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_value(int v) { value = v; }
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit Task(std::coroutine_handle<promise_type> h) : handle{h} {}
+    Task(Task&& other) noexcept : handle{std::exchange(other.handle, {})} {}
+    Task(const Task&) = delete;
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    int get() {
+        handle.resume();
+        return handle.promise().value;
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+using SmallPromise = mp::pooled_promise<512, 4>;
+using SmallTask = Task<SmallPromise>;
+
+SmallTask add(int a, int b) { co_return a + b; }
+
+SmallTask big_frame(int seed) {
+    std::array<int, 1024> locals{};
+    locals[static_cast<size_t>(seed) % locals.size()] = seed;
+    co_await std::suspend_always{};
+    co_return locals[static_cast<size_t>(seed) % locals.size()];
+}
+
+/**
+ * Runs a coroutine from its destructor: built before the thread's pool, it is destroyed after it.
+ */
+struct LateUser {
+    int* result;
+
+    ~LateUser() {
+        auto task = add(1, 2);
+        *result = task.get();
+    }
+};
+
+int main() {
+    using namespace boost::ut;
+
+    "Frames come from the pool"_test = [] {
+        expect(SmallPromise::pooled_frames() == 0_u);
+        {
+            auto a = add(1, 2);
+            auto b = add(3, 4);
+            expect(SmallPromise::pooled_frames() == 2_u);
+            expect(a.get() == 3_i);
+            expect(b.get() == 7_i);
+        }
+        expect(SmallPromise::pooled_frames() == 0_u);
+    };
+
+    "Full pool falls back to the heap"_test = [] {
+        std::vector<SmallTask> tasks;
+        for (int i = 0; i < 6; ++i) {
+            tasks.push_back(add(i, i));
+        }
+        expect(SmallPromise::pooled_frames() == 4_u);
+
+        for (int i = 0; i < 6; ++i) {
+            expect(tasks[static_cast<size_t>(i)].get() == 2 * i);
+        }
+        tasks.clear();
+        expect(SmallPromise::pooled_frames() == 0_u);
+    };
+
+    "Large frame falls back to the heap"_test = [] {
+        auto task = big_frame(42);
+        expect(SmallPromise::pooled_frames() == 0_u);
+        task.handle.resume();
+        expect(task.get() == 42_i);
+    };
+
+    "Frame destroyed on another thread"_test = [] {
+        {
+            auto task = add(5, 6);
+            expect(SmallPromise::pooled_frames() == 1_u);
+
+            std::thread{[t = std::move(task)]() mutable { expect(t.get() == 11_i); }}.join();
+            // Queued on the remote free stack, taken back by the next allocation
+            expect(SmallPromise::pooled_frames() == 1_u);
+        }
+        auto next = add(0, 0);
+        expect(SmallPromise::pooled_frames() == 1_u);
+    };
+
+    "Frame outliving its thread"_test = [] {
+        std::vector<SmallTask> tasks;
+        std::thread{[&] { tasks.push_back(add(20, 22)); }}.join();
+
+        expect(tasks.front().get() == 42_i);
+        tasks.clear();
+    };
+
+    "Frames outliving their thread destroyed on several threads"_test = [] {
+        std::vector<SmallTask> tasks;
+        std::thread{[&] {
+            tasks.push_back(add(1, 1));
+            tasks.push_back(add(2, 2));
+            tasks.push_back(add(3, 3));
+        }}.join();
+
+        std::thread{[t = std::move(tasks[0])]() mutable { expect(t.get() == 2_i); }}.join();
+        std::thread{[t = std::move(tasks[1])]() mutable { expect(t.get() == 4_i); }}.join();
+        // The last frame deletes the orphaned pool
+        expect(tasks[2].get() == 6_i);
+        tasks.clear();
+    };
+
+    "Coroutine created after the thread released its pool"_test = [] {
+        int result{0};
+        std::thread{[&] {
+            thread_local LateUser user{&result};
+            auto task = add(0, 0);
+            expect(task.get() == 0_i);
+        }}.join();
+        expect(result == 3_i);
+    };
+}
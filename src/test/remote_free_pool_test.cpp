@@ -0,0 +1,166 @@
+#include "memory_pool/types.hpp"
+
+#include <boost/ut.hpp>
+#include <memory_pool/remote_free_pool.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Tracked {
+    static inline std::atomic_int alive{0};
+
+    std::string name{};
+
+    Tracked() { ++alive; }
+    explicit Tracked(std::string n) : name{std::move(n)} { ++alive; }
+    ~Tracked() { --alive; }
+};
+
+int main() {
+    using namespace boost::ut;
+
+    "Allocate - not initialized"_test = [] {
+        mp::remote_free_pool<Tracked, 4> pool;
+
+        auto result = pool.allocate();
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::not_initialized);
+    };
+
+    "Deallocate - owner releases right away"_test = [] {
+        mp::remote_free_pool<Tracked, 2> pool;
+        expect(fatal(pool.initialize().has_value()));
+        expect(pool.is_owner());
+
+        auto a = pool.allocate("a");
+        expect(fatal(a.has_value()));
+        expect((*a)->name == "a");
+        expect(pool.owns(*a));
+        expect(pool.status().used == 1_u);
+
+        expect(pool.deallocate(*a).has_value());
+        expect(pool.status().used == 0_u);
+        expect(Tracked::alive == 0_i);
+
+        // Double free
+        auto again = pool.deallocate(*a);
+        expect(!again.has_value());
+        expect(again.error().code == mp::error::code_e::deallocation_has_failed);
+    };
+
+    "Deallocate - foreign pointer"_test = [] {
+        mp::remote_free_pool<Tracked, 2> pool;
+        expect(fatal(pool.initialize().has_value()));
+        Tracked outsider;
+
+        expect(!pool.owns(&outsider));
+        auto result = pool.deallocate(&outsider);
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::deallocation_has_failed);
+    };
+
+    "Deallocate - remote frees are drained by the next allocation"_test = [] {
+        mp::remote_free_pool<Tracked, 2> pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        auto a = pool.allocate("a");
+        auto b = pool.allocate("b");
+        expect(fatal(a.has_value() && b.has_value()));
+        expect(!pool.allocate().has_value());
+
+        std::thread{[&] {
+            expect(!pool.is_owner());
+            expect(pool.deallocate(*a).has_value());
+            expect(pool.deallocate(*b).has_value());
+        }}.join();
+
+        // Destroyed by the remote thread, but still counted until the owner takes the slots back
+        expect(Tracked::alive == 0_i);
+        expect(pool.status().used == 2_u);
+
+        auto c = pool.allocate("c");
+        expect(fatal(c.has_value()));
+        expect(pool.status().used == 1_u);
+        expect(pool.drain_remote_frees() == 0_u);
+        expect(pool.deallocate(*c).has_value());
+    };
+
+    "Deallocate - concurrent remote frees"_test = [] {
+        constexpr size_t threads = 4u;
+        constexpr size_t per_thread = 256u;
+        mp::remote_free_pool<Tracked, threads * per_thread> pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        std::vector<Tracked*> objects;
+        for (size_t i = 0u; i < threads * per_thread; ++i) {
+            auto obj = pool.allocate();
+            expect(fatal(obj.has_value()));
+            objects.push_back(*obj);
+        }
+        {
+            std::vector<std::jthread> freeing;
+            for (size_t t = 0u; t < threads; ++t) {
+                freeing.emplace_back([&, t] {
+                    for (size_t i = t * per_thread; i < (t + 1u) * per_thread; ++i) {
+                        std::ignore = pool.deallocate(objects[i]);
+                    }
+                });
+            }
+        }
+        expect(Tracked::alive == 0_i);
+        expect(pool.drain_remote_frees() == threads * per_thread);
+        expect(pool.status().used == 0_u);
+    };
+
+    "Fast path - try_allocate / deallocate_unchecked"_test = [] {
+        mp::remote_free_pool<int, 1> pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        int* a = pool.try_allocate(7);
+        expect(fatal(a != nullptr));
+        expect(*a == 7_i);
+        expect(pool.try_allocate(8) == nullptr);
+
+        std::thread{[&] { pool.deallocate_unchecked(a); }}.join();
+        int* b = pool.try_allocate(9);
+        expect(b == a);
+        pool.deallocate_unchecked(b);
+        expect(pool.status().used == 0_u);
+    };
+
+    "Take ownership"_test = [] {
+        mp::remote_free_pool<Tracked, 4> pool;
+        expect(fatal(pool.initialize().has_value()));
+        auto a = pool.allocate("a");
+        expect(fatal(a.has_value()));
+
+        std::thread{[&] {
+            pool.take_ownership();
+            expect(pool.is_owner());
+            expect(pool.deallocate(*a).has_value());
+            expect(pool.status().used == 0_u);
+            expect(pool.allocate("b").has_value());
+        }}.join();
+
+        expect(!pool.is_owner());
+        pool.take_ownership();
+        expect(pool.status().used == 1_u);
+    };
+
+    "Deinitialize - destroys the live objects only"_test = [] {
+        {
+            mp::remote_free_pool<Tracked, 4> pool;
+            expect(fatal(pool.initialize().has_value()));
+            auto a = pool.allocate();
+            auto b = pool.allocate();
+            std::ignore = pool.allocate();
+            expect(fatal(a.has_value() && b.has_value()));
+            std::ignore = pool.deallocate(*a);
+            std::thread{[&] { std::ignore = pool.deallocate(*b); }}.join();
+            expect(Tracked::alive == 1_i);
+        }
+        expect(Tracked::alive == 0_i);
+    };
+}
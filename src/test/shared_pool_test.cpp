@@ -0,0 +1,350 @@
+#include "memory_pool/types.hpp"
+
+#include <boost/ut.hpp>
+#include <memory_pool/shared_pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Coroutine started eagerly and never awaited, its frame is released when it completes.
+ */
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+/**
+ * Single threaded scheduler: runs the queued coroutines in order until none is left.
+ */
+class Scheduler {
+public:
+    auto schedule() {
+        struct awaiter {
+            Scheduler& scheduler;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { scheduler.ready_.push_back(h); }
+            void await_resume() const noexcept {}
+        };
+        return awaiter{*this};
+    }
+
+    void run() {
+        while (!ready_.empty()) {
+            auto h = ready_.front();
+            ready_.pop_front();
+            h.resume();
+        }
+    }
+
+private:
+    std::deque<std::coroutine_handle<>> ready_;
+};
+
+/**
+ * Fixed set of threads resuming the scheduled coroutines.
+ */
+class Executor {
+public:
+    explicit Executor(size_t threads) {
+        for (size_t i = 0u; i < threads; ++i) {
+            workers_.emplace_back([this](std::stop_token stop) {
+                for (;;) {
+                    std::coroutine_handle<> h;
+                    {
+                        std::unique_lock lock{mutex_};
+                        cv_.wait(lock, stop, [this] { return !ready_.empty(); });
+                        if (ready_.empty()) {
+                            return;
+                        }
+                        h = ready_.front();
+                        ready_.pop_front();
+                    }
+                    h.resume();
+                }
+            });
+        }
+    }
+
+    auto schedule() {
+        struct awaiter {
+            Executor& executor;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) {
+                // Once h is queued another thread may resume it and destroy this awaiter
+                Executor& target = executor;
+                {
+                    std::lock_guard lock{target.mutex_};
+                    target.ready_.push_back(h);
+                }
+                target.cv_.notify_one();
+            }
+            void await_resume() const noexcept {}
+        };
+        return awaiter{*this};
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable_any cv_;
+    std::deque<std::coroutine_handle<>> ready_;
+    std::vector<std::jthread> workers_;
+};
+
+int main() {
+    using namespace boost::ut;
+
+    "Allocate - never waits"_test = [] {
+        mp::shared_pool<std::string, 1> pool;
+        expect(!pool.allocate().has_value());
+        expect(fatal(pool.initialize().has_value()));
+
+        auto a = pool.allocate("a");
+        expect(fatal(a.has_value()));
+        expect(**a == "a");
+
+        auto b = pool.allocate("b");
+        expect(!b.has_value());
+        expect(b.error().code == mp::error::code_e::not_enough_space_in_allocator);
+
+        expect(pool.deallocate(*a).has_value());
+        auto again = pool.deallocate(*a);
+        expect(!again.has_value());
+        expect(again.error().code == mp::error::code_e::deallocation_has_failed);
+    };
+
+    "Async allocate - does not suspend with free slots"_test = [] {
+        mp::shared_pool<int, 2> pool;
+        expect(fatal(pool.initialize().has_value()));
+        int* got{nullptr};
+
+        [](auto& pool, int*& got) -> Detached {
+            auto obj = co_await pool.async_allocate(42);
+            got = obj.value_or(nullptr);
+        }(pool, got);
+
+        expect(fatal(got != nullptr));
+        expect(*got == 42_i);
+        expect(pool.waiting() == 0_u);
+    };
+
+    "Async allocate - waiters resumed in FIFO order on a single thread scheduler"_test = [] {
+        mp::shared_pool<int, 1> pool;
+        expect(fatal(pool.initialize().has_value()));
+        Scheduler scheduler;
+        std::vector<int> order;
+
+        auto first = pool.allocate(0);
+        expect(fatal(first.has_value()));
+
+        const auto worker = [](auto& pool, Scheduler& scheduler, std::vector<int>& order, int id) -> Detached {
+            co_await scheduler.schedule();
+            auto obj = co_await pool.async_allocate(id);
+            order.push_back(**obj);
+            co_await scheduler.schedule();
+            std::ignore = pool.deallocate(*obj);
+        };
+        for (int id = 1; id <= 3; ++id) {
+            worker(pool, scheduler, order, id);
+        }
+        scheduler.run();
+        expect(pool.waiting() == 3_u);
+        expect(order.empty());
+
+        // Each slot freed goes to the next waiter in arrival order
+        expect(pool.deallocate(*first).has_value());
+        scheduler.run();
+        expect(order == std::vector<int>{1, 2, 3});
+        expect(pool.waiting() == 0_u);
+        expect(pool.status().used == 0_u);
+    };
+
+    "Async allocate - allocate() does not overtake waiters"_test = [] {
+        mp::shared_pool<int, 1> pool;
+        expect(fatal(pool.initialize().has_value()));
+        auto first = pool.allocate(0);
+        bool resumed{false};
+
+        [](auto& pool, bool& resumed) -> Detached {
+            auto obj = co_await pool.async_allocate(1);
+            resumed = obj.has_value();
+        }(pool, resumed);
+
+        expect(!resumed);
+        expect(pool.deallocate(*first).has_value());
+        expect(resumed);
+        expect(!pool.allocate(2).has_value());
+    };
+
+    "Async allocate - deinitialize resumes the waiters"_test = [] {
+        mp::shared_pool<int, 1> pool;
+        expect(fatal(pool.initialize().has_value()));
+        std::ignore = pool.allocate(0);
+        mp::error::code_e code{mp::error::code_e::ok};
+
+        [](auto& pool, mp::error::code_e& code) -> Detached {
+            auto obj = co_await pool.async_allocate(1);
+            code = obj ? mp::error::code_e::ok : obj.error().code;
+        }(pool, code);
+
+        pool.deinitialize();
+        expect(code == mp::error::code_e::not_initialized);
+    };
+
+    "Async allocate - multi-threaded executor"_test = [] {
+        constexpr size_t slots = 2u;
+        constexpr int tasks = 16;
+        constexpr int rounds = 200;
+        mp::shared_pool<int, slots> pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        std::atomic_int live{0};
+        std::atomic_int max_live{0};
+        std::atomic_int done{0};
+        {
+            Executor executor{4u};
+
+            const auto worker = [](auto& pool, Executor& executor, std::atomic_int& live, std::atomic_int& max_live,
+                                   std::atomic_int& done) -> Detached {
+                for (int round = 0; round < rounds; ++round) {
+                    co_await executor.schedule();
+                    auto obj = co_await pool.async_allocate(round);
+                    if (!obj) {
+                        std::terminate();
+                    }
+                    const int now = ++live;
+                    int seen = max_live.load();
+                    while (now > seen && !max_live.compare_exchange_weak(seen, now)) {
+                    }
+                    // Hop to another thread while holding the slot
+                    co_await executor.schedule();
+                    --live;
+                    std::ignore = pool.deallocate(*obj);
+                }
+                ++done;
+            };
+            for (int t = 0; t < tasks; ++t) {
+                worker(pool, executor, live, max_live, done);
+            }
+            while (done.load() != tasks) {
+                std::this_thread::yield();
+            }
+        }
+        expect(max_live.load() <= static_cast<int>(slots));
+        expect(pool.status().used == 0_u);
+        expect(pool.waiting() == 0_u);
+    };
+
+    "Allocate wait - returns at once with free slots"_test = [] {
+        mp::shared_pool<int, 1> pool;
+        expect(!pool.allocate_wait(std::chrono::milliseconds{1}).has_value());
+        expect(fatal(pool.initialize().has_value()));
+
+        auto obj = pool.allocate_wait(std::chrono::seconds{0}, 7);
+        expect(fatal(obj.has_value()));
+        expect(**obj == 7_i);
+    };
+
+    "Allocate wait - times out"_test = [] {
+        using namespace std::chrono_literals;
+        mp::shared_pool<int, 1> pool;
+        expect(fatal(pool.initialize().has_value()));
+        std::ignore = pool.allocate(0);
+
+        const auto start = std::chrono::steady_clock::now();
+        auto obj = pool.allocate_wait(20ms, 1);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        expect(!obj.has_value());
+        expect(obj.error().code == mp::error::code_e::timed_out);
+        expect(elapsed >= 20ms);
+    };
+
+    "Allocate wait - woken by deallocate"_test = [] {
+        using namespace std::chrono_literals;
+        mp::shared_pool<int, 1> pool;
+        expect(fatal(pool.initialize().has_value()));
+        auto first = pool.allocate(0);
+        expect(fatal(first.has_value()));
+
+        std::jthread releaser{[&] {
+            std::this_thread::sleep_for(10ms);
+            std::ignore = pool.deallocate(*first);
+        }};
+        auto obj = pool.allocate_wait(10s, 1);
+        expect(fatal(obj.has_value()));
+        expect(**obj == 1_i);
+    };
+
+    "Allocate wait - deinitialize wakes the sleepers"_test = [] {
+        using namespace std::chrono_literals;
+        mp::shared_pool<int, 1> pool;
+        expect(fatal(pool.initialize().has_value()));
+        expect(fatal(pool.allocate(0).has_value()));
+        std::atomic_int not_initialized{0};
+        const auto start = std::chrono::steady_clock::now();
+        {
+            std::vector<std::jthread> sleepers;
+            for (int t = 0; t < 3; ++t) {
+                sleepers.emplace_back([&] {
+                    auto obj = pool.allocate_wait(30s, 1);
+                    if (!obj && obj.error().code == mp::error::code_e::not_initialized) {
+                        ++not_initialized;
+                    }
+                });
+            }
+            std::this_thread::sleep_for(50ms);
+            pool.deinitialize();
+        }
+        expect(not_initialized.load() == 3_i);
+        expect(std::chrono::steady_clock::now() - start < 10s);
+    };
+
+    "Allocate wait - threads contending for few slots"_test = [] {
+        using namespace std::chrono_literals;
+        constexpr size_t slots = 2u;
+        constexpr int threads = 8;
+        constexpr int rounds = 500;
+        mp::shared_pool<int, slots> pool;
+        expect(fatal(pool.initialize().has_value()));
+        std::atomic_int live{0};
+        std::atomic_int max_live{0};
+        std::atomic_int failures{0};
+        {
+            std::vector<std::jthread> workers;
+            for (int t = 0; t < threads; ++t) {
+                workers.emplace_back([&] {
+                    for (int round = 0; round < rounds; ++round) {
+                        auto obj = pool.allocate_wait(10s, round);
+                        if (!obj) {
+                            ++failures;
+                            continue;
+                        }
+                        const int now = ++live;
+                        int seen = max_live.load();
+                        while (now > seen && !max_live.compare_exchange_weak(seen, now)) {
+                        }
+                        --live;
+                        std::ignore = pool.deallocate(*obj);
+                    }
+                });
+            }
+        }
+        expect(failures.load() == 0_i);
+        expect(max_live.load() <= static_cast<int>(slots));
+        expect(pool.status().used == 0_u);
+    };
+}
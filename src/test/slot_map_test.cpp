@@ -0,0 +1,146 @@
+#include "memory_pool/types.hpp"
+
+#include <boost/ut.hpp>
+#include <memory_pool/slot_map.hpp>
+
+#include <cstddef>
+#include <new>
+#include <string>
+#include <vector>
+
+// Array allocations left before operator new[] throws, negative for never
+static int array_news_before_failure = -1;
+
+void* operator new[](std::size_t size) {
+    if (array_news_before_failure == 0) {
+        array_news_before_failure = -1;
+        throw std::bad_alloc{};
+    }
+    if (array_news_before_failure > 0) {
+        --array_news_before_failure;
+    }
+    return ::operator new(size);
+}
+
+void operator delete[](void* ptr) noexcept { ::operator delete(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept { ::operator delete(ptr); }
+
+struct Entity {
+    std::string name{};
+    int hp{0};
+};
+
+int main() {
+    using namespace boost::ut;
+
+    "Allocate - not initialized"_test = [] {
+        mp::slot_map<Entity, 4> map;
+
+        auto result = map.allocate();
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::not_initialized);
+    };
+
+    "Allocate - lookup by handle"_test = [] {
+        mp::slot_map<Entity, 4> map;
+        expect(fatal(map.initialize().has_value()));
+
+        auto a = map.allocate("a", 10);
+        auto b = map.allocate("b", 20);
+        expect(fatal(a.has_value() && b.has_value()));
+        expect(*a != *b);
+
+        expect(fatal(map.get(*b) != nullptr));
+        expect(map.get(*b)->name == "b");
+        expect(map.get(*a)->hp == 10);
+        expect(map.get(mp::handle_t{}) == nullptr);
+        expect(map.status().used == 2_u);
+    };
+
+    "Deallocate - stale handle is detected"_test = [] {
+        mp::slot_map<Entity, 1> map;
+        expect(fatal(map.initialize().has_value()));
+
+        auto first = map.allocate("first", 1);
+        expect(fatal(first.has_value()));
+        expect(map.deallocate(*first).has_value());
+
+        auto second = map.allocate("second", 2);
+        expect(fatal(second.has_value()));
+        expect(second->index == first->index);
+
+        // Same slot, new generation
+        expect(!map.contains(*first));
+        expect(map.get(*first) == nullptr);
+        expect(map.get(*second)->name == "second");
+
+        auto again = map.deallocate(*first);
+        expect(!again.has_value());
+        expect(again.error().code == mp::error::code_e::invalid_handle);
+        expect(map.contains(*second));
+    };
+
+    "Allocate - fail - no space left"_test = [] {
+        mp::slot_map<Entity, 2> map;
+        expect(fatal(map.initialize().has_value()));
+
+        expect(map.allocate().has_value());
+        expect(map.allocate().has_value());
+
+        auto result = map.allocate();
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::not_enough_space_in_allocator);
+    };
+
+    "Initialize - index table allocation fails"_test = [] {
+        mp::slot_map<Entity, 4> map;
+        array_news_before_failure = 1;
+
+        auto result = map.initialize();
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::cannot_reserve_system_memory);
+        expect(!map.is_initialized());
+        expect(map.initialize().has_value());
+    };
+
+    "Compact - dense prefix, handles preserved"_test = [] {
+        mp::slot_map<Entity, 64> map;
+        expect(fatal(map.initialize().has_value()));
+
+        std::vector<mp::handle_t> handles;
+        for (int i = 0; i < 40; ++i) {
+            handles.push_back(*map.allocate(std::to_string(i), i));
+        }
+        for (int i = 0; i < 40; i += 3) {
+            expect(map.deallocate(handles[i]).has_value());
+        }
+        expect(!map.is_compacted());
+
+        auto dense = map.compact();
+        expect(fatal(dense.has_value()));
+        expect(dense->size() == 26_u);
+        expect(map.is_compacted());
+
+        int sum = 0;
+        for (const auto& entity : *dense) {
+            sum += entity.hp;
+        }
+        expect(sum == 780 - 273);
+
+        for (int i = 0; i < 40; ++i) {
+            if (i % 3 == 0) {
+                expect(!map.contains(handles[i]));
+            } else {
+                expect(fatal(map.get(handles[i]) != nullptr));
+                expect(map.get(handles[i])->name == std::to_string(i));
+                expect(map.get(handles[i]) < dense->data() + dense->size());
+            }
+        }
+
+        auto next = map.allocate("next", 0);
+        expect(fatal(next.has_value()));
+        expect(map.get(*next) == dense->data() + 26);
+        expect(map.is_compacted());
+    };
+}
@@ -170,4 +170,42 @@ int main() {
         expect(status.used == 1u);
         expect(status.free == 9u);
     };
+
+    "Next in use - crosses words"_test = [] {
+        mp::slot_status_registry<100> slot;
+
+        expect(slot.next_in_use(0u) == 100u);
+
+        std::ignore = slot.fetch(70u);
+        for (size_t i = 0u; i < 70u; ++i) {
+            if (i != 3u && i != 40u && i != 69u) {
+                slot.release(i);
+            }
+        }
+        expect(slot.next_in_use(0u) == 3u);
+        expect(slot.next_in_use(4u) == 40u);
+        expect(slot.next_in_use(41u) == 69u);
+        expect(slot.next_in_use(70u) == 100u);
+        expect(slot.next_in_use(1000u) == 100u);
+
+        std::vector<size_t> visited;
+        slot.for_each_in_use([&](size_t idx) { visited.push_back(idx); });
+        expect(visited == std::vector<size_t>{3u, 40u, 69u});
+    };
+
+    "Next free and claim"_test = [] {
+        mp::slot_status_registry<40> slot;
+
+        expect(slot.claim(35u));
+        expect(!slot.claim(35u));
+        expect(!slot.claim(40u));
+        expect(slot.next_free(35u) == 36u);
+
+        std::ignore = slot.fetch(35u);
+        expect(slot.next_free(0u) == 36u);
+
+        std::ignore = slot.fetch(4u);
+        expect(slot.next_free(0u) == 40u);
+        expect(slot.status().free == 0u);
+    };
 }
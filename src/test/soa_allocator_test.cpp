@@ -0,0 +1,138 @@
+#include "memory_pool/types.hpp"
+
+#include <boost/ut.hpp>
+#include <memory_pool/soa_allocator.hpp>
+
+#include <string>
+#include <tuple>
+
+struct Particle {
+    float x{0.f};
+    float y{0.f};
+    float z{0.f};
+    int id{0};
+};
+
+int main() {
+    using namespace boost::ut;
+
+    "Fields - aggregate decomposition"_test = [] {
+        using pool_t = mp::soa_allocator<Particle, 8>;
+
+        expect(pool_t::field_count == 4_u);
+        expect(std::is_same_v<pool_t::field_t<0>, float>);
+        expect(std::is_same_v<pool_t::field_t<3>, int>);
+    };
+
+    "Allocate - not initialized"_test = [] {
+        mp::soa_allocator<Particle, 8> pool;
+
+        auto result = pool.allocate();
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::not_initialized);
+        expect(!pool.field<0>().has_value());
+    };
+
+    "Allocate - per field values"_test = [] {
+        mp::soa_allocator<Particle, 8> pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        auto a = pool.allocate(1.f, 2.f, 3.f, 7);
+        expect(fatal(a.has_value()));
+        expect(a->index() == 0_u);
+        expect(1._f == a->get<0>());
+        expect(a->get<3>() == 7);
+
+        auto b = pool.allocate(Particle{.x = 4.f, .y = 5.f, .z = 6.f, .id = 8});
+        expect(fatal(b.has_value()));
+        expect(b->index() == 1_u);
+
+        const Particle loaded = b->load();
+        expect(5._f == loaded.y);
+        expect(loaded.id == 8);
+
+        expect(pool.status().used == 2_u);
+    };
+
+    "Allocate - fail - no space left"_test = [] {
+        mp::soa_allocator<Particle, 2> pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        expect(pool.allocate().has_value());
+        expect(pool.allocate().has_value());
+
+        auto result = pool.allocate();
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::not_enough_space_in_allocator);
+    };
+
+    "Reference - assignment copies the fields"_test = [] {
+        mp::soa_allocator<Particle, 8> pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        const auto a = *pool.allocate(1.f, 2.f, 3.f, 7);
+        const auto b = *pool.allocate(4.f, 5.f, 6.f, 8);
+        pool[a.index()] = pool[b.index()];
+
+        // a still designates slot 0, which now holds the values of slot 1
+        expect(a.index() == 0_u);
+        expect(4._f == a.get<0>());
+        expect(a.get<3>() == 8);
+        expect(b.get<3>() == 8);
+    };
+
+    "Allocate - tuple of fields"_test = [] {
+        mp::soa_allocator<std::tuple<int, std::string>, 4> pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        auto ref = pool.allocate(3, std::string{"three"});
+        expect(fatal(ref.has_value()));
+        expect(ref->get<1>() == "three");
+
+        *ref = std::tuple<int, std::string>{4, "four"};
+        expect(ref->get<0>() == 4);
+        expect(std::get<1>(ref->load()) == "four");
+    };
+
+    "Field span - contiguous per field"_test = [] {
+        mp::soa_allocator<Particle, 16> pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        for (int i = 0; i < 10; ++i) {
+            expect(fatal(pool.allocate(float(i), 0.f, 0.f, i).has_value()));
+        }
+        auto xs = pool.field<0>();
+        expect(fatal(xs.has_value()));
+        expect(xs->size() == 16_u);
+
+        float sum = 0.f;
+        for (const float x : *xs) {
+            sum += x;
+        }
+        expect(45._f == sum);
+        expect(&(*xs)[1] == &(*xs)[0] + 1);
+    };
+
+    "Deallocate - resets fields and slot"_test = [] {
+        mp::soa_allocator<Particle, 2> pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        auto a = pool.allocate(1.f, 1.f, 1.f, 1);
+        auto b = pool.allocate(2.f, 2.f, 2.f, 2);
+        expect(fatal(a.has_value() && b.has_value()));
+        expect(!pool.allocate().has_value());
+
+        expect(pool.deallocate(*a).has_value());
+        expect(!pool.is_live(0));
+        expect(pool[0].get<3>() == 0);
+
+        auto again = pool.deallocate(*a);
+        expect(!again.has_value());
+        expect(again.error().code == mp::error::code_e::deallocation_has_failed);
+
+        auto c = pool.allocate();
+        expect(fatal(c.has_value()));
+        expect(c->index() == 0_u);
+        expect(pool.status().used == 2_u);
+    };
+}
@@ -0,0 +1,135 @@
+#include "memory_pool/types.hpp"
+
+#include <boost/ut.hpp>
+#include <memory_pool/stack_allocator.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+
+struct Point {
+    double x{0.0};
+    double y{0.0};
+};
+
+struct Throwing {
+    Throwing() { throw std::runtime_error{"ctor"}; }
+};
+
+int main() {
+    using namespace boost::ut;
+
+    "Allocate - not initialized"_test = [] {
+        mp::stack_allocator<256> stack;
+
+        auto result = stack.allocate(16u);
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::not_initialized);
+        expect(!stack.make<Point>().has_value());
+    };
+
+    "Allocate - alignment and exhaustion"_test = [] {
+        mp::stack_allocator<128> stack;
+        expect(fatal(stack.initialize().has_value()));
+
+        auto a = stack.allocate(1u, 1u);
+        auto b = stack.allocate(8u, 32u);
+        expect(fatal(a.has_value() && b.has_value()));
+        expect(reinterpret_cast<std::uintptr_t>(*b) % 32u == 0_u);
+        expect(stack.status().used == 40_u);
+
+        auto bad = stack.allocate(8u, 12u);
+        expect(!bad.has_value());
+        expect(bad.error().code == mp::error::code_e::bad_logic);
+
+        auto full = stack.allocate(89u, 1u);
+        expect(!full.has_value());
+        expect(full.error().code == mp::error::code_e::not_enough_space_in_allocator);
+        expect(stack.allocate(88u, 1u).has_value());
+        expect(stack.status().free == 0_u);
+    };
+
+    "Rewind - releases everything above the marker"_test = [] {
+        mp::stack_allocator<256> stack;
+        expect(fatal(stack.initialize().has_value()));
+
+        auto base = stack.make<Point>(1.0, 2.0);
+        expect(fatal(base.has_value()));
+        const auto marker = stack.mark();
+
+        auto first = stack.make<Point>(3.0, 4.0);
+        expect(fatal(first.has_value()));
+        expect(stack.status().used == 32_u);
+
+        expect(stack.rewind(marker).has_value());
+        expect(stack.status().used == 16_u);
+        expect(!stack.owns(*first));
+        expect((*base)->y == 2.0_d);
+
+        // LIFO reuse: the next object takes the released memory
+        auto second = stack.make<Point>();
+        expect(fatal(second.has_value()));
+        expect(*second == *first);
+    };
+
+    "Rewind - stale marker"_test = [] {
+        mp::stack_allocator<256> stack;
+        expect(fatal(stack.initialize().has_value()));
+
+        const auto outer = stack.mark();
+        expect(stack.allocate(64u).has_value());
+        const auto inner = stack.mark();
+
+        expect(stack.rewind(outer).has_value());
+        auto stale = stack.rewind(inner);
+        expect(!stale.has_value());
+        expect(stale.error().code == mp::error::code_e::bad_logic);
+    };
+
+    "Scoped - nested guards"_test = [] {
+        mp::stack_allocator<1024> stack;
+        expect(fatal(stack.initialize().has_value()));
+        {
+            const auto outer = stack.scoped();
+            expect(stack.allocate(100u).has_value());
+            {
+                const auto inner = stack.scoped();
+                expect(stack.allocate(200u).has_value());
+                expect(stack.status().used == 312_u);
+            }
+            expect(stack.status().used == 100_u);
+        }
+        expect(stack.status().used == 0_u);
+        expect(stack.mark() == stack.mark());
+    };
+
+    "Scoped - rewound below the guard during its scope"_test = [] {
+        mp::stack_allocator<1024> stack;
+        expect(fatal(stack.initialize().has_value()));
+        const auto m0 = stack.mark();
+        auto* x = static_cast<std::byte*>(nullptr);
+        {
+            const auto outer = stack.scoped();
+            expect(stack.allocate(100u).has_value());
+            {
+                const auto inner = stack.scoped();
+                expect(stack.rewind(m0).has_value());
+                x = static_cast<std::byte*>(*stack.allocate(200u));
+            }
+            // The inner guard must not raise the top back over x
+            expect(stack.status().used == 200_u);
+            auto* next = static_cast<std::byte*>(*stack.allocate(50u));
+            expect(next >= x + 200);
+        }
+        expect(stack.status().used == 0_u);
+    };
+
+    "Make - constructor throws"_test = [] {
+        mp::stack_allocator<64> stack;
+        expect(fatal(stack.initialize().has_value()));
+
+        auto result = stack.make<Throwing>();
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::exception_caught_in_ctor);
+        expect(stack.status().used == 0_u);
+    };
+}
@@ -0,0 +1,98 @@
+#ifndef MP_STATS
+#define MP_STATS
+#endif
+
+#include "memory_pool/types.hpp"
+
+#include <boost/ut.hpp>
+#include <memory_pool/allocator.hpp>
+#include <memory_pool/stats.hpp>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+struct Parameter {
+    std::string id{};
+    float value{0.f};
+};
+
+int main() {
+    using namespace boost::ut;
+
+    "Stats - counters"_test = [] {
+        mp::allocator<Parameter, 100> alloc;
+        std::ignore = alloc.allocate();
+        alloc.initialize();
+
+        std::vector<Parameter*> allocated;
+        for (int i = 0; i < 100; ++i) {
+            allocated.push_back(*alloc.allocate());
+        }
+        expect(!alloc.allocate().has_value());
+        expect(!alloc.try_allocate());
+
+        for (int i = 0; i < 60; ++i) {
+            alloc.deallocate(allocated[i]);
+        }
+        auto bucket = alloc.allocate_bucket<10>();
+        expect(bucket.has_value());
+
+        const auto stats = alloc.stats_snapshot();
+        expect(stats.allocations == 110_u);
+        expect(stats.deallocations == 60_u);
+        expect(stats.bucket_allocations == 1_u);
+        expect(stats.high_water_mark == 100_u);
+        expect(stats.failures[size_t(mp::error::code_e::not_initialized)] == 1_u);
+        expect(stats.failures[size_t(mp::error::code_e::not_enough_space_in_allocator)] == 2_u);
+        expect(stats.fetches == 101_u);
+        expect(stats.mean_fetch_scan_length() >= 1.0);
+    };
+
+    "Stats - threads are aggregated"_test = [] {
+        auto pool = *mp::pool<Parameter, 4096>::create();
+        std::mutex mutex;
+        {
+            std::vector<std::jthread> threads;
+            for (int t = 0; t < 4; ++t) {
+                threads.emplace_back([&] {
+                    for (int i = 0; i < 100; ++i) {
+                        // Each thread counts in its own shard, the allocator itself is not thread safe
+                        std::scoped_lock lock{mutex};
+                        std::ignore = pool.allocate();
+                    }
+                });
+            }
+        }
+        const auto stats = pool.stats_snapshot();
+        expect(stats.allocations == 400_u);
+        expect(stats.high_water_mark == 400_u);
+    };
+
+    "Stats - dump to a file descriptor"_test = [] {
+        mp::stats_t stats;
+        stats.allocations = 7u;
+        stats.failures[size_t(mp::error::code_e::not_enough_space_in_allocator)] = 2u;
+
+        int fds[2];
+        expect(fatal(::pipe(fds) == 0));
+        expect(stats.write(fds[1], mp::stats_t::format_e::json));
+        ::close(fds[1]);
+
+        char buffer[512] = {};
+        const auto n = ::read(fds[0], buffer, sizeof(buffer) - 1u);
+        ::close(fds[0]);
+        expect(fatal(n > 0));
+
+        const std::string json{buffer, size_t(n)};
+        expect(json.starts_with("{\"allocations\":7,"));
+        expect(json.find("\"not_enough_space_in_allocator\":2") != std::string::npos);
+
+        const std::string text = stats.to_string();
+        expect(text.find("allocations: 7\n") == 0u);
+        expect(text.find("failures.not_enough_space_in_allocator: 2\n") != std::string::npos);
+    };
+}
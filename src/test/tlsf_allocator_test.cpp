@@ -0,0 +1,128 @@
+#include "memory_pool/types.hpp"
+
+#include <boost/ut.hpp>
+#include <memory_pool/tlsf_allocator.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <utility>
+#include <vector>
+
+int main() {
+    using namespace boost::ut;
+
+    "Allocate - not initialized"_test = [] {
+        mp::tlsf_allocator<4096> tlsf;
+
+        auto result = tlsf.allocate(64u);
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::not_initialized);
+    };
+
+    "Allocate - aligned and rounded to 16 bytes"_test = [] {
+        mp::tlsf_allocator<4096> tlsf;
+        expect(fatal(tlsf.initialize().has_value()));
+        const auto initial = tlsf.status().free;
+        expect(initial == decltype(tlsf)::max_allocation);
+
+        auto a = tlsf.allocate(1u);
+        auto b = tlsf.allocate(100u);
+        expect(fatal(a.has_value() && b.has_value()));
+        expect(reinterpret_cast<std::uintptr_t>(*a) % 16u == 0_u);
+        expect(reinterpret_cast<std::uintptr_t>(*b) % 16u == 0_u);
+        expect(tlsf.block_size(*a) == 16_u);
+        expect(tlsf.block_size(*b) == 112_u);
+        // Two payloads and their headers
+        expect(tlsf.status().free == initial - 16u - 112u - 2u * 16u);
+    };
+
+    "Allocate - too big or exhausted"_test = [] {
+        mp::tlsf_allocator<4096> tlsf;
+        expect(fatal(tlsf.initialize().has_value()));
+
+        auto big = tlsf.allocate(4096u);
+        expect(!big.has_value());
+        expect(big.error().code == mp::error::code_e::out_of_bounds);
+
+        auto whole = tlsf.allocate(2048u);
+        expect(fatal(whole.has_value()));
+        auto full = tlsf.allocate(2048u);
+        expect(!full.has_value());
+        expect(full.error().code == mp::error::code_e::not_enough_space_in_allocator);
+    };
+
+    "Deallocate - neighbours merge back into one block"_test = [] {
+        mp::tlsf_allocator<8192> tlsf;
+        expect(fatal(tlsf.initialize().has_value()));
+        const auto initial = tlsf.status().free;
+
+        std::vector<void*> blocks;
+        for (size_t i = 0u; i < 8u; ++i) {
+            auto block = tlsf.allocate(512u);
+            expect(fatal(block.has_value()));
+            blocks.push_back(*block);
+        }
+        // Free every other block then the rest, merging with both neighbours
+        for (size_t i = 0u; i < blocks.size(); i += 2u) {
+            expect(tlsf.deallocate(blocks[i]).has_value());
+        }
+        for (size_t i = 1u; i < blocks.size(); i += 2u) {
+            expect(tlsf.deallocate(blocks[i]).has_value());
+        }
+        expect(tlsf.status().free == initial);
+
+        auto whole = tlsf.allocate(decltype(tlsf)::max_allocation);
+        expect(whole.has_value());
+    };
+
+    "Deallocate - foreign pointer and double free"_test = [] {
+        mp::tlsf_allocator<4096> tlsf;
+        expect(fatal(tlsf.initialize().has_value()));
+        int outsider{0};
+
+        auto foreign = tlsf.deallocate(&outsider);
+        expect(!foreign.has_value());
+        expect(foreign.error().code == mp::error::code_e::deallocation_has_failed);
+
+        auto block = tlsf.allocate(64u);
+        expect(fatal(block.has_value()));
+        expect(!tlsf.deallocate(static_cast<std::byte*>(*block) + 8).has_value());
+        expect(tlsf.deallocate(*block).has_value());
+        expect(!tlsf.deallocate(*block).has_value());
+        expect(tlsf.block_size(*block) == 0_u);
+    };
+
+    "Random workload - blocks never overlap and the region comes back whole"_test = [] {
+        mp::tlsf_allocator<1u << 20u> tlsf;
+        expect(fatal(tlsf.initialize().has_value()));
+        const auto initial = tlsf.status().free;
+        std::mt19937 rng{11u};
+        std::vector<std::pair<std::byte*, size_t>> live;
+
+        for (size_t step = 0u; step < 20000u; ++step) {
+            if (live.empty() || rng() % 3u != 0u) {
+                const size_t bytes = 1u + rng() % (rng() % 8u == 0u ? 65536u : 512u);
+                if (auto block = tlsf.allocate(bytes); block) {
+                    expect(tlsf.block_size(*block) >= bytes);
+                    std::memset(*block, static_cast<int>(step), bytes);
+                    live.emplace_back(static_cast<std::byte*>(*block), bytes);
+                }
+            } else {
+                const size_t victim = rng() % live.size();
+                expect(tlsf.deallocate(live[victim].first).has_value());
+                live[victim] = live.back();
+                live.pop_back();
+            }
+        }
+        std::ranges::sort(live);
+        for (size_t i = 1u; i < live.size(); ++i) {
+            expect(live[i - 1u].first + live[i - 1u].second <= live[i].first);
+        }
+        for (auto [block, size] : live) {
+            expect(tlsf.deallocate(block).has_value());
+        }
+        expect(tlsf.status().free == initial);
+    };
+}
@@ -0,0 +1,138 @@
+#include "memory_pool/types.hpp"
+
+#include <boost/ut.hpp>
+#include <memory_pool/variant_pool.hpp>
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct Heartbeat {
+    std::uint64_t sequence{0u};
+};
+
+struct Quote {
+    static inline int alive{0};
+
+    std::string symbol{};
+    double bid{0.0};
+    double ask{0.0};
+
+    Quote(std::string s, double b, double a) : symbol{std::move(s)}, bid{b}, ask{a} { ++alive; }
+    ~Quote() { --alive; }
+};
+
+struct alignas(32) Snapshot {
+    std::array<double, 16u> levels{};
+};
+
+struct Throwing {
+    Throwing() { throw std::runtime_error{"ctor"}; }
+};
+
+template <typename... TFns>
+struct overloaded : TFns... {
+    using TFns::operator()...;
+};
+
+int main() {
+    using namespace boost::ut;
+    using pool_t = mp::variant_pool<8, Heartbeat, Quote, Snapshot>;
+
+    "Allocate - not initialized"_test = [] {
+        pool_t pool;
+
+        auto result = pool.allocate<Heartbeat>();
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::not_initialized);
+    };
+
+    "Allocate - the types share the slots"_test = [] {
+        pool_t pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        auto heartbeat = pool.allocate<Heartbeat>(7u);
+        auto quote = pool.allocate<Quote>("EURUSD", 1.08, 1.09);
+        auto snapshot = pool.allocate<Snapshot>();
+        expect(fatal(heartbeat.has_value() && quote.has_value() && snapshot.has_value()));
+        expect((*heartbeat)->sequence == 7_u);
+        expect((*quote)->symbol == "EURUSD");
+        expect(reinterpret_cast<std::uintptr_t>(*snapshot) % 32u == 0_u);
+        expect(pool.status().used == 3_u);
+
+        expect(pool.holds(*quote));
+        expect(!pool.holds(reinterpret_cast<Heartbeat*>(*quote)));
+
+        // Fill the remaining slots with a single type
+        for (size_t i = 0u; i < 5u; ++i) {
+            expect(pool.allocate<Heartbeat>().has_value());
+        }
+        auto full = pool.allocate<Snapshot>();
+        expect(!full.has_value());
+        expect(full.error().code == mp::error::code_e::not_enough_space_in_allocator);
+    };
+
+    "Deallocate - checks the type of the slot"_test = [] {
+        pool_t pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        auto quote = pool.allocate<Quote>("GBPUSD", 1.26, 1.27);
+        expect(fatal(quote.has_value()));
+
+        auto wrong = pool.deallocate(reinterpret_cast<Heartbeat*>(*quote));
+        expect(!wrong.has_value());
+        expect(wrong.error().code == mp::error::code_e::deallocation_has_failed);
+        expect(Quote::alive == 1_i);
+
+        expect(pool.deallocate(*quote).has_value());
+        expect(Quote::alive == 0_i);
+        expect(!pool.deallocate(*quote).has_value());
+        expect(pool.status().used == 0_u);
+    };
+
+    "Allocate - constructor throws"_test = [] {
+        mp::variant_pool<2, Heartbeat, Throwing> pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        auto result = pool.allocate<Throwing>();
+        expect(!result.has_value());
+        expect(result.error().code == mp::error::code_e::exception_caught_in_ctor);
+        expect(pool.status().used == 0_u);
+    };
+
+    "Visit live - dispatches on the type tag"_test = [] {
+        pool_t pool;
+        expect(fatal(pool.initialize().has_value()));
+
+        auto first = pool.allocate<Heartbeat>(1u);
+        expect(pool.allocate<Quote>("USDJPY", 151.2, 151.3).has_value());
+        expect(pool.allocate<Heartbeat>(2u).has_value());
+        expect(pool.allocate<Snapshot>().has_value());
+        expect(fatal(first.has_value()));
+        expect(pool.deallocate(*first).has_value());
+
+        std::vector<std::string> seen;
+        auto visited = pool.visit_live(overloaded{
+            [&](Heartbeat& h) { seen.push_back("heartbeat " + std::to_string(h.sequence)); },
+            [&](Quote& q) { seen.push_back("quote " + q.symbol); },
+            [&](Snapshot&) { seen.push_back("snapshot"); },
+        });
+        expect(fatal(visited.has_value()));
+        expect(*visited == 3_u);
+        expect(seen == std::vector<std::string>{"quote USDJPY", "heartbeat 2", "snapshot"});
+    };
+
+    "Deinitialize - destroys the live objects"_test = [] {
+        {
+            pool_t pool;
+            expect(fatal(pool.initialize().has_value()));
+            expect(pool.allocate<Quote>("AUDUSD", 0.65, 0.66).has_value());
+            expect(pool.allocate<Quote>("NZDUSD", 0.59, 0.60).has_value());
+            expect(Quote::alive == 2_i);
+        }
+        expect(Quote::alive == 0_i);
+    };
+}